@@ -0,0 +1,98 @@
+#include "AhoCorasick.h"
+
+#include <deque>
+
+namespace hokee
+{
+void AhoCorasick::Add(const std::string& pattern, uint32_t id)
+{
+    if (!pattern.empty())
+    {
+        _patterns.emplace_back(pattern, id);
+    }
+}
+
+void AhoCorasick::Clear()
+{
+    *this = AhoCorasick();
+}
+
+void AhoCorasick::Build()
+{
+    // Map used characters to classes 1..n, all other characters to class 0
+    _classes.fill(0);
+    _classCount = 1;
+    for (const auto& pattern : _patterns)
+    {
+        for (const char c : pattern.first)
+        {
+            auto& charClass = _classes[static_cast<unsigned char>(c)];
+            if (charClass == 0)
+            {
+                charClass = static_cast<uint8_t>(_classCount++);
+            }
+        }
+    }
+
+    // Trie (missing transitions are 0, the root)
+    std::vector<std::vector<uint32_t>> stateOutputs(1);
+    _transitions.assign(_classCount, 0);
+    for (const auto& pattern : _patterns)
+    {
+        uint32_t state = 0;
+        for (const char c : pattern.first)
+        {
+            uint32_t& next = _transitions[state * _classCount + _classes[static_cast<unsigned char>(c)]];
+            if (next == 0)
+            {
+                next = static_cast<uint32_t>(stateOutputs.size());
+                stateOutputs.emplace_back();
+                _transitions.resize(_transitions.size() + _classCount, 0);
+            }
+            state = _transitions[state * _classCount + _classes[static_cast<unsigned char>(c)]];
+        }
+        stateOutputs[state].push_back(pattern.second);
+    }
+
+    // Breadth first: complete transitions with failure links and collect outputs of suffixes
+    std::vector<uint32_t> failure(stateOutputs.size(), 0);
+    std::deque<uint32_t> queue;
+    for (size_t c = 0; c < _classCount; ++c)
+    {
+        if (_transitions[c] != 0)
+        {
+            queue.push_back(_transitions[c]);
+        }
+    }
+    while (!queue.empty())
+    {
+        const uint32_t state = queue.front();
+        queue.pop_front();
+        const auto& fallback = stateOutputs[failure[state]];
+        stateOutputs[state].insert(stateOutputs[state].end(), fallback.begin(), fallback.end());
+
+        for (size_t c = 0; c < _classCount; ++c)
+        {
+            uint32_t& next = _transitions[state * _classCount + c];
+            const uint32_t failureNext = _transitions[failure[state] * _classCount + c];
+            if (next != 0)
+            {
+                failure[next] = failureNext;
+                queue.push_back(next);
+            }
+            else
+            {
+                next = failureNext;
+            }
+        }
+    }
+
+    _outputOffsets.assign(1, 0);
+    _outputs.clear();
+    for (const auto& outputs : stateOutputs)
+    {
+        _outputs.insert(_outputs.end(), outputs.begin(), outputs.end());
+        _outputOffsets.push_back(static_cast<uint32_t>(_outputs.size()));
+    }
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hokee
+{
+/// Multi-pattern substring search. Patterns are compiled into a dense automaton over the characters they use,
+/// so a text is searched for all patterns with a single pass.
+class AhoCorasick
+{
+    std::vector<std::pair<std::string, uint32_t>> _patterns{};
+    std::array<uint8_t, 256> _classes{};
+    size_t _classCount{1};
+    std::vector<uint32_t> _transitions{};
+    std::vector<uint32_t> _outputOffsets{};
+    std::vector<uint32_t> _outputs{};
+
+  public:
+    AhoCorasick() = default;
+    ~AhoCorasick() = default;
+
+    AhoCorasick(const AhoCorasick&) = default;
+    AhoCorasick& operator=(const AhoCorasick&) = default;
+    AhoCorasick(AhoCorasick&&) = default;
+    AhoCorasick& operator=(AhoCorasick&&) = default;
+
+    /// Adds a pattern which is reported as id. Empty patterns are ignored. Call Build() afterwards.
+    void Add(const std::string& pattern, uint32_t id);
+    void Build();
+    void Clear();
+
+    inline bool IsEmpty() const
+    {
+        return _patterns.empty();
+    }
+
+    /// Calls onMatch(id) for every occurrence of every pattern in text
+    template <typename F>
+    void Search(std::string_view text, F&& onMatch) const
+    {
+        if (_transitions.empty())
+        {
+            return;
+        }
+        uint32_t state = 0;
+        for (const char c : text)
+        {
+            state = _transitions[state * _classCount + _classes[static_cast<unsigned char>(c)]];
+            for (uint32_t o = _outputOffsets[state]; o < _outputOffsets[state + 1]; ++o)
+            {
+                onMatch(_outputs[o]);
+            }
+        }
+    }
+};
+} // namespace hokee
\ No newline at end of file
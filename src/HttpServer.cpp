@@ -5,12 +5,14 @@
 #include "Utils.h"
 #include "csv/CsvWriter.h"
 
+#include <cctype>
 #include <chrono>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 #include <cpp-httplib/httplib.h>
 #include <fmt/format.h>
@@ -81,6 +83,77 @@ void PrintRequest(const httplib::Request& req, const httplib::Response& res)
     Utils::PrintTrace(resStream.str());
 }
 
+/// Percent-encodes a parameter value for links, e.g. the spaces of a search query
+std::string EncodeParam(const std::string& value)
+{
+    std::string encoded{};
+    for (char c : value)
+    {
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '.' || c == '_' || c == '~')
+        {
+            encoded += c;
+        }
+        else
+        {
+            encoded += fmt::format("%{:02X}", static_cast<unsigned char>(c));
+        }
+    }
+    return encoded;
+}
+
+/// Reads a row count or position, std::stoul() would wrap negative numbers around
+size_t GetRowParam(const httplib::Request& req, const std::string& name, const std::string& page,
+                   size_t defaultValue)
+{
+    const std::string value = GetParam(req.params, name, page);
+    if (value.empty())
+    {
+        return defaultValue;
+    }
+    try
+    {
+        if (value.find_first_not_of("0123456789") == std::string::npos)
+        {
+            return std::stoul(value);
+        }
+    }
+    catch (const std::out_of_range&)
+    {
+    }
+    throw InternalException(__FILE__, __LINE__, fmt::format("Invalid value '{}' of parameter '{}'.", value, name));
+}
+
+/// Reads the offset, limit and search parameters of a table page (limit=0: all rows)
+HtmlTableWindow GetTableWindow(const httplib::Request& req, size_t defaultLimit)
+{
+    HtmlTableWindow window{};
+    const std::string page = req.path.substr(1);
+    std::string params{};
+    for (auto& p : req.params)
+    {
+        if (p.first != "offset" && p.first != "limit")
+        {
+            params += fmt::format("{}{}={}", params.empty() ? "?" : "&amp;", p.first, EncodeParam(p.second));
+        }
+    }
+    window.Search = GetParam(req.params, "search", page);
+    window.PageLink = page + params;
+    window.RowsLink = fs::path(page).replace_extension(".json").string() + params;
+
+    window.Offset = GetRowParam(req, "offset", page, 0);
+    window.Limit = GetRowParam(req, "limit", page, defaultLimit);
+    return window;
+}
+
+/// State of a table page, which is sent in chunks
+struct TablePageStream
+{
+    HtmlWriter Html{};
+    HtmlTableWindow Window{};
+    std::vector<CsvRowShared> Rows{};
+    size_t Next{0};
+};
+
 } // namespace
 
 bool HttpServer::TrySetContentFromCache(const httplib::Request& req, httplib::Response& res)
@@ -123,6 +196,154 @@ void HttpServer::SetContentAndSetCache(const httplib::Request& req, httplib::Res
     res.set_content(content, content_type);
 }
 
+void HttpServer::SetTableContent(const httplib::Request& req, httplib::Response& res, const std::string& title,
+                                 const std::vector<CsvRowShared>& rows, int filter)
+{
+    _lastUrl = GetUrl(req);
+
+    // Only the rows of the window are copied. They are written while the page is sent, so the first bytes do not
+    // depend on the row count.
+    auto stream = std::make_shared<TablePageStream>();
+    stream->Window = GetTableWindow(req, TABLE_PAGE_ROWS);
+    const size_t begin = stream->Window.GetBegin(rows.size());
+    const size_t end = stream->Window.GetEnd(rows.size());
+    stream->Rows.assign(rows.begin() + static_cast<std::ptrdiff_t>(begin),
+                        rows.begin() + static_cast<std::ptrdiff_t>(end));
+    HtmlGenerator::BeginTablePage(stream->Html, _database, title, filter, rows.size(), stream->Window);
+
+    auto tableContentProvider = [this, stream](size_t /*offset*/, httplib::DataSink& sink)
+    {
+        try
+        {
+            std::string chunk;
+            bool finished = false;
+            {
+                // Rules may be edited between two chunks, so the items are only read under the database lock
+                std::scoped_lock lock(_databaseMutex);
+                const size_t end = stream->Next + TABLE_ROWS_PER_CHUNK;
+                HtmlGenerator::AddTableRows(stream->Html, stream->Rows, stream->Next, end);
+                stream->Next = end;
+                finished = stream->Next >= stream->Rows.size();
+                if (finished)
+                {
+                    HtmlGenerator::EndTablePage(stream->Html, stream->Window);
+                    chunk = stream->Html.Finish();
+                }
+                else
+                {
+                    chunk = stream->Html.Flush();
+                }
+            }
+
+            sink.write(chunk.data(), chunk.size());
+            if (finished)
+            {
+                sink.done();
+            }
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            Utils::PrintError(fmt::format("Could not write table page: {}", e.what()));
+            return false;
+        }
+    };
+    res.set_chunked_content_provider(CONTENT_TYPE_HTML, tableContentProvider);
+}
+
+bool HttpServer::SelectTable(const httplib::Request& req, httplib::Response& res, const std::string& page,
+                             const TableHandler& tableHandler)
+{
+    // The search runs on the server, so it covers all rows of the table and not only the ones sent to the browser
+    const std::string search = GetParam(req.params, "search", page);
+    auto handler = [&](const std::string& title, const std::vector<CsvRowShared>& rows, int filter)
+    {
+        if (search.empty())
+        {
+            tableHandler(title, rows, filter);
+        }
+        else
+        {
+            tableHandler(title, _database.Search(rows, search), filter);
+        }
+    };
+
+    // all.html
+    if (page == HtmlGenerator::ALL_HTML)
+    {
+        handler("All items", _database.Data.GetRows(), 0);
+        return true;
+    }
+
+    // assigned.html
+    if (page == HtmlGenerator::ASSIGNED_HTML)
+    {
+        handler("Assigned items", _database.Assigned.GetRows(), 0);
+        return true;
+    }
+
+    // unassigned.html
+    if (page == HtmlGenerator::UNASSIGNED_HTML)
+    {
+        handler("Unassigned items", _database.Unassigned.GetRows(), 0);
+        return true;
+    }
+
+    // rules.html
+    if (page == HtmlGenerator::RULES_HTML)
+    {
+        handler("Rules", _database.Rules.GetRows(), 0);
+        return true;
+    }
+
+    // issues.html
+    if (page == HtmlGenerator::ISSUES_HTML)
+    {
+        handler("Issues", _database.Issues.GetRows(), 0);
+        return true;
+    }
+
+    // items.html
+    if (page == HtmlGenerator::ITEMS_HTML)
+    {
+        const std::string yearStr = GetParam(req.params, "year", HtmlGenerator::ITEMS_HTML);
+        if (yearStr.empty())
+        {
+            res.status = 404;
+            _errorMessage = fmt::format("'{}' requests must define non-empty parameter '{}'!",
+                                        HtmlGenerator::ITEMS_HTML, "year");
+            res.set_redirect(HtmlGenerator::INDEX_HTML);
+            return true;
+        }
+        const int year = std::stoi(yearStr);
+        std::string monthStr = GetParam(req.params, "month", HtmlGenerator::ITEMS_HTML);
+        if (monthStr.empty())
+        {
+            monthStr = "0";
+        }
+        const int month = std::stoi(monthStr);
+        std::string filterStr = GetParam(req.params, "filter", HtmlGenerator::ITEMS_HTML);
+        if (filterStr.empty())
+        {
+            filterStr = "0";
+        }
+        const int filter = std::stoi(filterStr);
+        const std::string cat = GetParam(req.params, "category", HtmlGenerator::ITEMS_HTML);
+
+        const std::vector<CsvRowShared> data = _database.GetItems(year, month, cat, filter);
+
+        std::string name = fmt::format("{}-{}: {}", month, year, cat);
+        if (month == 0)
+        {
+            name = fmt::format("{}: {}", year, cat);
+        }
+        handler(name, data, filter);
+        return true;
+    }
+
+    return false;
+}
+
 inline void HttpServer::HandleHtmlRequest(const httplib::Request& req, httplib::Response& res)
 {
     // Check Error
@@ -228,43 +449,13 @@ inline void HttpServer::HandleHtmlRequest(const httplib::Request& req, httplib::
         return;
     }
 
-    // all.html
-    if (req.path == std::string("/") + HtmlGenerator::ALL_HTML)
-    {
-        SetContent(req, res, HtmlGenerator::GetTablePage(_database, "All items", _database.Data, 0),
-                   CONTENT_TYPE_HTML);
-        return;
-    }
-
-    // assigned.html
-    if (req.path == std::string("/") + HtmlGenerator::ASSIGNED_HTML)
-    {
-        SetContent(req, res, HtmlGenerator::GetTablePage(_database, "Assigned items", _database.Assigned, 0),
-                   CONTENT_TYPE_HTML);
-        return;
-    }
-
-    // unassigned.html
-    if (req.path == std::string("/") + HtmlGenerator::UNASSIGNED_HTML)
-    {
-        SetContent(req, res, HtmlGenerator::GetTablePage(_database, "Unassigned items", _database.Unassigned, 0),
-                   CONTENT_TYPE_HTML);
-        return;
-    }
-
-    // rules.html
-    if (req.path == std::string("/") + HtmlGenerator::RULES_HTML)
+    // Table pages
+    auto setTableContentCallback = [&](const std::string& title, const std::vector<CsvRowShared>& rows, int filter)
     {
-        SetContent(req, res, HtmlGenerator::GetTablePage(_database, "Rules", _database.Rules, 0),
-                   CONTENT_TYPE_HTML);
-        return;
-    }
-
-    // issues.html
-    if (req.path == std::string("/") + HtmlGenerator::ISSUES_HTML)
+        SetTableContent(req, res, title, rows, filter);
+    };
+    if (SelectTable(req, res, req.path.substr(1), setTableContentCallback))
     {
-        SetContent(req, res, HtmlGenerator::GetTablePage(_database, "Issues", _database.Issues, 0),
-                   CONTENT_TYPE_HTML);
         return;
     }
 
@@ -312,57 +503,6 @@ inline void HttpServer::HandleHtmlRequest(const httplib::Request& req, httplib::
                    CONTENT_TYPE_HTML);
         return;
     }
-
-    // items.html
-    if (req.path == std::string("/") + HtmlGenerator::ITEMS_HTML)
-    {
-        const std::string yearStr = GetParam(req.params, "year", HtmlGenerator::ITEMS_HTML);
-        if (yearStr.empty())
-        {
-            res.status = 404;
-            _errorMessage = fmt::format("'{}' requests must define non-empty parameter '{}'!",
-                                        HtmlGenerator::ITEM_HTML, "year");
-            res.set_redirect(HtmlGenerator::INDEX_HTML);
-            return;
-        }
-        const int year = std::stoi(yearStr);
-        std::string monthStr = GetParam(req.params, "month", HtmlGenerator::ITEMS_HTML);
-        if (monthStr.empty())
-        {
-            monthStr = "0";
-        }
-        const int month = std::stoi(monthStr);
-        std::string filterStr = GetParam(req.params, "filter", HtmlGenerator::ITEMS_HTML);
-        if (filterStr.empty())
-        {
-            filterStr = "0";
-        }
-        const int filter = std::stoi(filterStr);
-        const std::string cat = GetParam(req.params, "category", HtmlGenerator::ITEMS_HTML);
-
-        CsvTable data{};
-        for (auto& item : _database.Data)
-        {
-            if (year == item->Date.GetYear() && (month == 0 || month == item->Date.GetMonth())
-                && (cat == "" || cat == item->Category))
-            {
-                if (filter == 0 || (filter < 0 && item->Value.ToDouble() < 0)
-                    || (filter > 0 && item->Value.ToDouble() >= 0))
-                {
-                    data.push_back(item);
-                }
-            }
-        }
-
-        std::string name = fmt::format("{}-{}: {}", month, year, cat);
-        if (month == 0)
-        {
-            name = fmt::format("{}: {}", year, cat);
-        }
-        SetContent(req, res, HtmlGenerator::GetTablePage(_database, name, data, filter), CONTENT_TYPE_HTML);
-        return;
-    }
-
     // default
     res.status = 404;
 }
@@ -431,6 +571,36 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
         }
     });
 
+    // Get rows of a table page as JSON, e.g. all.json for all.html
+    _server->Get("/(.*)\\.json", [&](const httplib::Request& req, httplib::Response& res) {
+        try
+        {
+            std::unique_lock<std::timed_mutex> lock(_databaseMutex, std::try_to_lock);
+            if (!lock.owns_lock())
+            {
+                res.status = 503;
+                return;
+            }
+
+            const HtmlTableWindow window = GetTableWindow(req, TABLE_PAGE_ROWS);
+            auto setRowsCallback = [&](const std::string& /*title*/, const std::vector<CsvRowShared>& rows,
+                                       int /*filter*/)
+            {
+                const size_t limit = window.Limit > 0 ? window.Limit : rows.size();
+                res.set_content(HtmlGenerator::GetTableRows(rows, window.Offset, limit), CONTENT_TYPE_JSON);
+            };
+            if (!SelectTable(req, res, std::string(req.matches[1]) + ".html", setRowsCallback))
+            {
+                res.status = 404;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            Utils::PrintError(fmt::format("Could not get rows {}: {}", GetUrl(req), e.what()));
+            res.status = 500;
+        }
+    });
+
     // Get JS javascript file
     _server->Get("/(.*\\.js)", [&](const httplib::Request& req, httplib::Response& res) {
         try
@@ -552,54 +722,49 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
             {
                 throw InternalException(__FILE__, __LINE__, "Could not get request parameter 'format'.");
             }
-            std::shared_ptr<CsvItem> rule = nullptr;
-            for (auto& r : _database.Rules)
-            {
-                if (fmt::format("{}", r->Id) == id)
-                {
-                    rule = r;
-                }
-            }
+            // Streamed table pages read the items between two chunks, so they are only changed under the lock
+            std::scoped_lock lock(_databaseMutex);
+            std::shared_ptr<CsvItem> rule = _database.Rules.FindItem(std::stoi(id));
             if (rule == nullptr)
             {
                 throw InternalException(__FILE__, __LINE__, fmt::format("Could not find rule with id={}.", id));
             }
 
             auto value = GetParam(req.params, "Category", HtmlGenerator::SAVE_RULE_CMD);
-            rule->Category = value;
+            rule->SetCategory(value);
             value = GetParam(req.params, "Account", HtmlGenerator::SAVE_RULE_CMD);
-            rule->Account = value;
+            rule->SetAccount(value);
             bool success = true;
             value = GetParam(req.params, "Date", HtmlGenerator::SAVE_RULE_CMD);
-            auto ruleBackup = rule->Date;
+            auto ruleBackup = rule->GetDate();
             try
             {
-                rule->Date = CsvDate(dateFormat, value);
+                rule->SetDate(CsvDate(dateFormat, value));
             }
             catch (std::runtime_error&)
             {
                 success = false;
-                rule->Date = ruleBackup;
+                rule->SetDate(ruleBackup);
             }
             value = GetParam(req.params, "Description", HtmlGenerator::SAVE_RULE_CMD);
-            rule->Description = value;
+            rule->SetDescription(value);
             value = GetParam(req.params, "PayerPayee", HtmlGenerator::SAVE_RULE_CMD);
-            rule->PayerPayee = value;
+            rule->SetPayerPayee(value);
             value = GetParam(req.params, "Type", HtmlGenerator::SAVE_RULE_CMD);
-            rule->Type = value;
+            rule->SetType(value);
             value = GetParam(req.params, "Value", HtmlGenerator::SAVE_RULE_CMD);
-            auto valueBackup = rule->Value;
+            auto valueBackup = rule->GetValue();
             try
             {
-                rule->Value = CsvValue(value, "???", -1, false);
+                rule->SetValue(CsvValue(value, "???", -1, false));
             }
-            catch (InternalException&)
+            catch (UserException&)
             {
                 success = false;
-                rule->Value = valueBackup;
+                rule->SetValue(valueBackup);
             }
 
-            _database.MatchRules();
+            _database.MatchRule(rule->Id);
             CsvWriter::Write(ruleSetFile, _database.Rules);
             res.set_redirect(
                 (fmt::format("{}?id={}&{}", HtmlGenerator::ITEM_HTML, id, success ? "saved" : "failed").c_str()));
@@ -624,6 +789,7 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
                      try
                      {
                          Utils::PrintTrace("Received save rules request");
+                         std::scoped_lock lock(_databaseMutex);
                          CsvWriter::Write(ruleSetFile, _database.Rules);
                          res.set_redirect((_lastUrl + "&saved").c_str());
                      }
@@ -683,7 +849,10 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
         {
             Utils::PrintTrace("Received backup rules request");
             fs::path backupPath = fmt::format("{}.{}.backup", ruleSetFile.string(), Utils::GenerateTimestamp());
-            CsvWriter::Write(ruleSetFile, _database.Rules);
+            {
+                std::scoped_lock lock(_databaseMutex);
+                CsvWriter::Write(ruleSetFile, _database.Rules);
+            }
             fs::copy_file(ruleSetFile, backupPath, fs::copy_options::overwrite_existing);
             res.set_redirect((_lastUrl).c_str());
         }
@@ -867,9 +1036,13 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
                                         fmt::format("Could not convert '{}' to 'int'. ({})", idStr, e.what()));
             }
             Utils::PrintInfo(fmt::format("Create new Rule based on id {}", id));
-            int nextId = _database.NewRule(id);
-            _database.MatchRules();
-            CsvWriter::Write(ruleSetFile, _database.Rules);
+            int nextId = -1;
+            {
+                std::scoped_lock lock(_databaseMutex);
+                nextId = _database.NewRule(id);
+                _database.MatchRule(nextId);
+                CsvWriter::Write(ruleSetFile, _database.Rules);
+            }
 
             std::string url = fmt::format("{}?id={}&saved", HtmlGenerator::ITEM_HTML, nextId);
             res.set_redirect(url.c_str());
@@ -908,6 +1081,7 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
                     throw InternalException(__FILE__, __LINE__,
                                             fmt::format("Could not convert '{}' to 'int'. ({})", idStr, e.what()));
                 }
+                std::scoped_lock lock(_databaseMutex);
                 int nextId = _database.DeleteRule(id);
                 std::string url;
                 if (nextId >= 0)
@@ -918,7 +1092,6 @@ HttpServer::HttpServer(const fs::path& inputDirectory, const fs::path& ruleSetFi
                 {
                     url = HtmlGenerator::INDEX_HTML;
                 }
-                _database.MatchRules();
                 CsvWriter::Write(ruleSetFile, _database.Rules);
                 res.set_redirect(url + "&saved");
             }
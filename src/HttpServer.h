@@ -2,10 +2,12 @@
 
 #include "html/HtmlGenerator.h"
 #include "Settings.h"
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace httplib
 {
@@ -23,6 +25,13 @@ class HttpServer
     static constexpr const char* CONTENT_TYPE_JS = "application/javascript";
     static constexpr const char* CONTENT_TYPE_PNG = "image/png";
     static constexpr const char* CONTENT_TYPE_ICO = "image/x-icon";
+    static constexpr const char* CONTENT_TYPE_JSON = "application/json";
+    static constexpr size_t TABLE_ROWS_PER_CHUNK = 1000;
+    /// Rows of a table page without limit parameter
+    static constexpr size_t TABLE_PAGE_ROWS = 1000;
+
+    typedef std::function<void(const std::string& title, const std::vector<CsvRowShared>& rows, int filter)>
+        TableHandler;
 
     std::unique_ptr<httplib::Server> _server;
     CsvDatabase _database{};
@@ -46,6 +55,13 @@ class HttpServer
     bool TrySetContentFromCache(const httplib::Request& req, httplib::Response& res);
     void SetContentAndSetCache(const httplib::Request& req, httplib::Response& res, const std::string& content,
                                const char* content_type);
+    /// Sends the window of a table page (see offset and limit parameters) in chunks
+    void SetTableContent(const httplib::Request& req, httplib::Response& res, const std::string& title,
+                         const std::vector<CsvRowShared>& rows, int filter);
+    /// Calls the handler with the rows of a table page, which match the search parameter. Returns false, if the
+    /// page is no table page. Requests with missing parameters are redirected to the index page.
+    bool SelectTable(const httplib::Request& req, httplib::Response& res, const std::string& page,
+                     const TableHandler& tableHandler);
     void HandleHtmlRequest(const httplib::Request& req, httplib::Response& res);
 
   public:
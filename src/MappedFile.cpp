@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+#include "InternalException.h"
+
+#include <fmt/format.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hokee
+{
+#ifdef _WIN32
+MappedFile::MappedFile(const fs::path& file)
+{
+    HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not open file {}", file.string()));
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not get size of file {}", file.string()));
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0)
+    {
+        CloseHandle(handle);
+        return;
+    }
+
+    _mapping = CreateFileMappingW(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (_mapping == nullptr)
+    {
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not map file {}", file.string()));
+    }
+
+    _data = static_cast<char*>(MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0));
+    if (_data == nullptr)
+    {
+        CloseHandle(_mapping);
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not map file {}", file.string()));
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping)
+    {
+        CloseHandle(_mapping);
+    }
+}
+#else
+MappedFile::MappedFile(const fs::path& file)
+{
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not open file {}", file.string()));
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not get size of file {}", file.string()));
+    }
+    _size = static_cast<size_t>(status.st_size);
+    if (_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not map file {}", file.string()));
+    }
+    madvise(data, _size, MADV_SEQUENTIAL);
+    _data = static_cast<char*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data)
+    {
+        munmap(_data, _size);
+    }
+}
+#endif
+} // namespace hokee
\ No newline at end of file
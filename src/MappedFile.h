@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Filesystem.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace hokee
+{
+/// Maps a file copy-on-write into memory. The content can be modified in place without touching the file on disk.
+class MappedFile
+{
+    char* _data{nullptr};
+    size_t _size{0};
+#ifdef _WIN32
+    void* _mapping{nullptr};
+#endif
+
+  public:
+    MappedFile() = delete;
+    explicit MappedFile(const fs::path& file);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    inline char* GetData()
+    {
+        return _data;
+    }
+
+    inline size_t GetSize() const
+    {
+        return _size;
+    }
+
+    inline std::string_view GetView() const
+    {
+        return std::string_view(_data, _size);
+    }
+};
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "ThreadPool.h"
+#include "Utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace hokee
+{
+namespace
+{
+thread_local const ThreadPool* _workerPool = nullptr;
+thread_local size_t _workerIndex = 0;
+} // namespace
+
+size_t ThreadPool::GetWorkerIndex() const
+{
+    return _workerPool == this ? _workerIndex : _threads.size();
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        _queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        _threads.emplace_back(&ThreadPool::Work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::GetInstance()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    // Workers keep their own tasks local, other threads distribute round robin
+    const size_t worker = GetWorkerIndex();
+    const size_t queueIndex = worker < _queues.size() ? worker : _nextQueue++ % _queues.size();
+    {
+        // Count the task before it is visible to other workers, so RunTask never decrements below zero
+        std::scoped_lock lock(_mutex);
+        ++_pending;
+    }
+    {
+        std::scoped_lock lock(_queues[queueIndex]->Mutex);
+        _queues[queueIndex]->Tasks.push_back(std::move(task));
+    }
+    _condition.notify_one();
+}
+
+bool ThreadPool::RunTask(size_t queueIndex)
+{
+    std::function<void()> task;
+    for (size_t i = 0; i < _queues.size() && !task; ++i)
+    {
+        // Newest task of the own queue first, then steal the oldest task of another queue
+        auto& queue = *_queues[(queueIndex + i) % _queues.size()];
+        std::scoped_lock lock(queue.Mutex);
+        if (queue.Tasks.empty())
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            task = std::move(queue.Tasks.back());
+            queue.Tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.Tasks.front());
+            queue.Tasks.pop_front();
+        }
+    }
+    if (!task)
+    {
+        return false;
+    }
+
+    {
+        std::scoped_lock lock(_mutex);
+        --_pending;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::Work(size_t index)
+{
+    _workerPool = this;
+    _workerIndex = index;
+    while (true)
+    {
+        if (RunTask(index))
+        {
+            continue;
+        }
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return _stop || _pending > 0; });
+        if (_stop && _pending == 0)
+        {
+            return;
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(std::string_view phase, size_t count,
+                             const std::function<void(size_t, size_t)>& body, size_t chunkSize)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (chunkSize == 0)
+    {
+        chunkSize = std::max<size_t>(1, count / (_threads.size() * 8));
+    }
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    // Busy time and number of chunks per worker, the last slot is used by all other threads
+    struct Phase
+    {
+        std::mutex Mutex{};
+        std::condition_variable Done{};
+        size_t Remaining{0};
+        std::exception_ptr Error{};
+        std::vector<std::chrono::steady_clock::duration> Busy{};
+        std::vector<size_t> Chunks{};
+    } state;
+    state.Remaining = chunkCount;
+    state.Busy.resize(_threads.size() + 1);
+    state.Chunks.resize(_threads.size() + 1);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        Submit([this, &state, &body, c, chunkSize, count]() {
+            const auto chunkStart = std::chrono::steady_clock::now();
+            std::exception_ptr error{};
+            try
+            {
+                body(c * chunkSize, std::min(count, (c + 1) * chunkSize));
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            const size_t slot = GetWorkerIndex();
+
+            std::scoped_lock lock(state.Mutex);
+            state.Busy[slot] += std::chrono::steady_clock::now() - chunkStart;
+            state.Chunks[slot]++;
+            if (error && !state.Error)
+            {
+                state.Error = error;
+            }
+            if (--state.Remaining == 0)
+            {
+                state.Done.notify_all();
+            }
+        });
+    }
+
+    // Help while waiting
+    const size_t queueIndex = GetWorkerIndex() % _queues.size();
+    while (true)
+    {
+        {
+            std::scoped_lock lock(state.Mutex);
+            if (state.Remaining == 0)
+            {
+                break;
+            }
+        }
+        if (!RunTask(queueIndex))
+        {
+            std::unique_lock lock(state.Mutex);
+            state.Done.wait_for(lock, std::chrono::milliseconds(1), [&state] { return state.Remaining == 0; });
+        }
+    }
+    const auto wall = std::chrono::steady_clock::now() - start;
+
+    if (!phase.empty())
+    {
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        std::vector<double> busy;
+        for (size_t t = 0; t < state.Busy.size(); ++t)
+        {
+            if (state.Chunks[t] > 0)
+            {
+                busy.push_back(Milliseconds(state.Busy[t]).count());
+            }
+        }
+        const auto [minBusy, maxBusy] = std::minmax_element(busy.begin(), busy.end());
+        Utils::PrintTrace(fmt::format("{}: {:.1f} ms, {} chunks on {} threads, busy min {:.1f} ms, max {:.1f} ms",
+                                      phase, Milliseconds(wall).count(), chunkCount, busy.size(), *minBusy,
+                                      *maxBusy));
+    }
+
+    if (state.Error)
+    {
+        std::rethrow_exception(state.Error);
+    }
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace hokee
+{
+/// Work-stealing thread pool. Every worker has its own task queue, idle workers steal from the others.
+/// Threads waiting for a ParallelFor execute queued tasks as well, so ParallelFor may be nested.
+class ThreadPool
+{
+    struct TaskQueue
+    {
+        std::mutex Mutex{};
+        std::deque<std::function<void()>> Tasks{};
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> _queues{};
+    std::vector<std::thread> _threads{};
+    std::mutex _mutex{};
+    std::condition_variable _condition{};
+    size_t _pending{0};
+    std::atomic<size_t> _nextQueue{0};
+    bool _stop{false};
+
+    /// Index of the calling worker thread or GetThreadCount() for other threads
+    size_t GetWorkerIndex() const;
+    bool RunTask(size_t queueIndex);
+    void Work(size_t index);
+
+  public:
+    /// threadCount 0: hardware concurrency
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /// Pool shared by loading, matching and report generation
+    static ThreadPool& GetInstance();
+
+    inline size_t GetThreadCount() const
+    {
+        return _threads.size();
+    }
+
+    void Submit(std::function<void()> task);
+
+    /// Calls body(begin, end) for chunks of [0, count) in parallel and returns when all chunks are done.
+    /// chunkSize 0 selects a size with several chunks per thread. Rethrows the first exception of body.
+    /// Traces wall time and the busy time per thread of the phase (including nested loops run while waiting).
+    void ParallelFor(std::string_view phase, size_t count, const std::function<void(size_t, size_t)>& body,
+                     size_t chunkSize = 0);
+};
+} // namespace hokee
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "UserException.h"
-#include "html/HtmlGenerator.h"
+#include "html/HtmlElement.h"
 
 #include <fmt/format.h>
 #include <sstream>
@@ -9,7 +9,9 @@
 #include <cstdlib>
 
 #include <array>
+#include <atomic>
 #include <ctime>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -26,7 +28,7 @@ namespace
 {
 std::mutex _lastMessageMutex{};
 std::vector<std::string> _lastMessages{};
-int _uniqueId{0};
+std::atomic<int> _uniqueId{0};
 bool _verbose{false};
 
 const std::string DropXmlTags(std::string_view msg)
@@ -390,6 +392,44 @@ std::string EscapeHtml(std::string text)
     return buffer.str();
 }
 
+std::string EscapeJson(std::string_view text)
+{
+    std::string buffer{};
+    buffer.reserve(text.size());
+    for (const char character : text)
+    {
+        switch (character)
+        {
+            case '\"':
+                buffer += "\\\"";
+                break;
+            case '\\':
+                buffer += "\\\\";
+                break;
+            case '\n':
+                buffer += "\\n";
+                break;
+            case '\r':
+                buffer += "\\r";
+                break;
+            case '\t':
+                buffer += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20)
+                {
+                    buffer += fmt::format("\\u{:04x}", static_cast<int>(character));
+                }
+                else
+                {
+                    buffer += character;
+                }
+                break;
+        }
+    }
+    return buffer;
+}
+
 std::string GenerateSupportMail(const fs::path& ruleSetFile, const fs::path& inputDir)
 {
     std::stringstream mail{};
@@ -37,6 +37,7 @@ fs::path GetHomeDir();
 fs::path GetTempDir();
 
 std::string EscapeHtml(std::string text);
+std::string EscapeJson(std::string_view text);
 std::string GenerateSupportMail(const fs::path& ruleSetFile, const fs::path& inputDir);
 std::string GenerateTimestamp();
 
@@ -0,0 +1,63 @@
+#include "CsvArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace hokee
+{
+std::atomic<size_t> CsvArena::_totalAllocationCount{0};
+std::atomic<size_t> CsvArena::_totalBlockCount{0};
+std::atomic<size_t> CsvArena::_totalBlockBytes{0};
+
+void* CsvArena::Allocate(size_t size, size_t alignment)
+{
+    const size_t padding = (alignment - reinterpret_cast<uintptr_t>(_position) % alignment) % alignment;
+    if (_position == nullptr || padding + size > _available)
+    {
+        // Blocks grow, so small files (rules, settings) stay small and large ones need few blocks
+        const size_t blockSize = std::max(_nextBlockSize, size + alignment);
+        _blocks.emplace_back(new std::byte[blockSize]);
+        _position = _blocks.back().get();
+        _available = blockSize;
+        _nextBlockSize = std::min(_nextBlockSize * 2, MAX_BLOCK_SIZE);
+        _blockBytes += blockSize;
+        ++_totalBlockCount;
+        _totalBlockBytes += blockSize;
+        return Allocate(size, alignment);
+    }
+
+    void* result = _position + padding;
+    _position += padding + size;
+    _available -= padding + size;
+    ++_allocationCount;
+    ++_totalAllocationCount;
+    return result;
+}
+
+std::string_view CsvArena::AddText(std::string_view text)
+{
+    if (text.empty())
+    {
+        return {};
+    }
+    char* bytes = static_cast<char*>(Allocate(text.size(), 1));
+    std::memcpy(bytes, text.data(), text.size());
+    return {bytes, text.size()};
+}
+
+size_t CsvArena::GetTotalAllocationCount()
+{
+    return _totalAllocationCount;
+}
+
+size_t CsvArena::GetTotalBlockCount()
+{
+    return _totalBlockCount;
+}
+
+size_t CsvArena::GetTotalBlockBytes()
+{
+    return _totalBlockBytes;
+}
+} // namespace hokee
\ No newline at end of file
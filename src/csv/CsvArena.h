@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace hokee
+{
+/// Monotonic arena for the rows of one table (a parsed file or chunk). Memory is taken from growing blocks and
+/// released only as a whole, when the last row allocated with a CsvArenaAllocator and the last columns referring
+/// to its text are gone, e.g. when the data is reloaded. Not thread-safe, use one arena per table.
+/// The CsvItem objects, their shared_ptr control blocks and the bytes of the text fields live in the arena. Text
+/// that is replaced (rule edits) stays in the arena until it is released.
+class CsvArena
+{
+    static constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+
+    static std::atomic<size_t> _totalAllocationCount;
+    static std::atomic<size_t> _totalBlockCount;
+    static std::atomic<size_t> _totalBlockBytes;
+
+    std::vector<std::unique_ptr<std::byte[]>> _blocks{};
+    std::byte* _position{nullptr};
+    size_t _available{0};
+    size_t _nextBlockSize{MIN_BLOCK_SIZE};
+    size_t _allocationCount{0};
+    size_t _blockBytes{0};
+
+  public:
+    CsvArena() = default;
+    ~CsvArena() = default;
+
+    CsvArena(const CsvArena&) = delete;
+    CsvArena& operator=(const CsvArena&) = delete;
+    CsvArena(CsvArena&&) = delete;
+    CsvArena& operator=(CsvArena&&) = delete;
+
+    void* Allocate(size_t size, size_t alignment);
+
+    /// Copies text into the arena, empty text needs no memory
+    std::string_view AddText(std::string_view text);
+
+    inline size_t GetAllocationCount() const
+    {
+        return _allocationCount;
+    }
+
+    inline size_t GetBlockCount() const
+    {
+        return _blocks.size();
+    }
+
+    inline size_t GetBlockBytes() const
+    {
+        return _blockBytes;
+    }
+
+    /// Counters of all arenas since program start (the number of blocks is the number of heap allocations)
+    static size_t GetTotalAllocationCount();
+    static size_t GetTotalBlockCount();
+    static size_t GetTotalBlockBytes();
+};
+
+/// Allocator for std::allocate_shared. Every copy keeps the arena alive.
+template <typename T>
+class CsvArenaAllocator
+{
+    template <typename U>
+    friend class CsvArenaAllocator;
+
+    std::shared_ptr<CsvArena> _arena;
+
+  public:
+    typedef T value_type;
+
+    explicit CsvArenaAllocator(std::shared_ptr<CsvArena> arena)
+        : _arena{std::move(arena)}
+    {
+    }
+
+    template <typename U>
+    CsvArenaAllocator(const CsvArenaAllocator<U>& other)
+        : _arena{other._arena}
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* /*unused*/, size_t /*unused*/)
+    {
+    }
+
+    template <typename U>
+    bool operator==(const CsvArenaAllocator<U>& other) const
+    {
+        return _arena == other._arena;
+    }
+
+    template <typename U>
+    bool operator!=(const CsvArenaAllocator<U>& other) const
+    {
+        return _arena != other._arena;
+    }
+};
+} // namespace hokee
\ No newline at end of file
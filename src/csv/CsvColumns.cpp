@@ -0,0 +1,205 @@
+#include "CsvColumns.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <utility>
+
+namespace hokee
+{
+namespace
+{
+template <typename T>
+void ReorderColumn(std::vector<T>& column, const std::vector<size_t>& order)
+{
+    std::vector<T> reordered;
+    reordered.reserve(order.size());
+    for (size_t row : order)
+    {
+        reordered.push_back(std::move(column[row]));
+    }
+    column.swap(reordered);
+}
+
+template <typename T>
+void AppendColumn(std::vector<T>& column, std::vector<T>& other)
+{
+    column.insert(column.end(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+    other.clear();
+}
+
+/// Text of the arenas is only referenced by its row, so it can be changed in place
+void LowerText(std::string_view text)
+{
+    char* bytes = const_cast<char*>(text.data());
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        bytes[i] = static_cast<char>(std::tolower(bytes[i]));
+    }
+}
+
+template <typename T>
+void EraseFromColumn(std::vector<T>& column, size_t row)
+{
+    column.erase(column.begin() + static_cast<std::ptrdiff_t>(row));
+}
+
+template <typename T>
+void EraseFromColumn(std::vector<T>& column, const std::vector<size_t>& rows)
+{
+    size_t target = rows.front();
+    auto removed = rows.begin();
+    for (size_t i = rows.front(); i < column.size(); ++i)
+    {
+        if (removed != rows.end() && *removed == i)
+        {
+            ++removed;
+            continue;
+        }
+        column[target++] = std::move(column[i]);
+    }
+    column.resize(target);
+}
+} // namespace
+
+void CsvColumns::KeepArenas(const CsvColumns& other)
+{
+    auto keep = [this](const std::shared_ptr<CsvArena>& arena) {
+        if (arena != _arena && std::find(_otherArenas.begin(), _otherArenas.end(), arena) == _otherArenas.end())
+        {
+            _otherArenas.push_back(arena);
+        }
+    };
+    keep(other._arena);
+    for (const auto& arena : other._otherArenas)
+    {
+        keep(arena);
+    }
+}
+
+void CsvColumns::Reserve(size_t size)
+{
+    _dates.reserve(size);
+    _types.reserve(size);
+    _payerPayees.reserve(size);
+    _accounts.reserve(size);
+    _descriptions.reserve(size);
+    _values.reserve(size);
+    _categories.reserve(size);
+    _files.reserve(size);
+    _lines.reserve(size);
+}
+
+size_t CsvColumns::AddRow()
+{
+    _dates.emplace_back();
+    _types.emplace_back();
+    _payerPayees.emplace_back();
+    _accounts.emplace_back();
+    _descriptions.emplace_back();
+    _values.emplace_back();
+    _categories.emplace_back();
+    _files.emplace_back();
+    _lines.push_back(-1);
+    return _dates.size() - 1;
+}
+
+size_t CsvColumns::CopyRow(const CsvColumns& other, size_t row)
+{
+    _dates.push_back(other._dates[row]);
+    _types.push_back(other._types[row]);
+    _payerPayees.push_back(_arena->AddText(other._payerPayees[row]));
+    _accounts.push_back(other._accounts[row]);
+    _descriptions.push_back(_arena->AddText(other._descriptions[row]));
+    _values.push_back(other._values[row]);
+    _categories.push_back(other._categories[row]);
+    _files.push_back(other._files[row]);
+    _lines.push_back(other._lines[row]);
+    return _dates.size() - 1;
+}
+
+size_t CsvColumns::MoveRow(CsvColumns& other, size_t row)
+{
+    // Moved rows often come from the same columns
+    if (_otherArenas.empty() || _otherArenas.back() != other._arena)
+    {
+        KeepArenas(other);
+    }
+    _dates.push_back(other._dates[row]);
+    _types.push_back(other._types[row]);
+    _payerPayees.push_back(other._payerPayees[row]);
+    _accounts.push_back(other._accounts[row]);
+    _descriptions.push_back(other._descriptions[row]);
+    _values.push_back(other._values[row]);
+    _categories.push_back(other._categories[row]);
+    _files.push_back(other._files[row]);
+    _lines.push_back(other._lines[row]);
+    return _dates.size() - 1;
+}
+
+void CsvColumns::Append(CsvColumns&& other)
+{
+    KeepArenas(other);
+    AppendColumn(_dates, other._dates);
+    AppendColumn(_types, other._types);
+    AppendColumn(_payerPayees, other._payerPayees);
+    AppendColumn(_accounts, other._accounts);
+    AppendColumn(_descriptions, other._descriptions);
+    AppendColumn(_values, other._values);
+    AppendColumn(_categories, other._categories);
+    AppendColumn(_files, other._files);
+    AppendColumn(_lines, other._lines);
+}
+
+void CsvColumns::EraseRow(size_t row)
+{
+    EraseFromColumn(_dates, row);
+    EraseFromColumn(_types, row);
+    EraseFromColumn(_payerPayees, row);
+    EraseFromColumn(_accounts, row);
+    EraseFromColumn(_descriptions, row);
+    EraseFromColumn(_values, row);
+    EraseFromColumn(_categories, row);
+    EraseFromColumn(_files, row);
+    EraseFromColumn(_lines, row);
+}
+
+void CsvColumns::EraseRows(const std::vector<size_t>& rows)
+{
+    if (rows.empty())
+    {
+        return;
+    }
+    EraseFromColumn(_dates, rows);
+    EraseFromColumn(_types, rows);
+    EraseFromColumn(_payerPayees, rows);
+    EraseFromColumn(_accounts, rows);
+    EraseFromColumn(_descriptions, rows);
+    EraseFromColumn(_values, rows);
+    EraseFromColumn(_categories, rows);
+    EraseFromColumn(_files, rows);
+    EraseFromColumn(_lines, rows);
+}
+
+void CsvColumns::Reorder(const std::vector<size_t>& order)
+{
+    ReorderColumn(_dates, order);
+    ReorderColumn(_types, order);
+    ReorderColumn(_payerPayees, order);
+    ReorderColumn(_accounts, order);
+    ReorderColumn(_descriptions, order);
+    ReorderColumn(_values, order);
+    ReorderColumn(_categories, order);
+    ReorderColumn(_files, order);
+    ReorderColumn(_lines, order);
+}
+
+void CsvColumns::ToLower(size_t row)
+{
+    _types[row] = _types[row].ToLower();
+    LowerText(_payerPayees[row]);
+    _accounts[row] = _accounts[row].ToLower();
+    LowerText(_descriptions[row]);
+    _categories[row] = _categories[row].ToLower();
+}
+} // namespace hokee
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "csv/CsvArena.h"
+#include "csv/CsvDate.h"
+#include "csv/CsvSymbol.h"
+#include "csv/CsvValue.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hokee
+{
+/// Fields of the rows of a CsvTable, stored by column. Row r of the columns belongs to row r of the table, so
+/// scans over all rows (summary, items pages, search and rule matching) read only the columns they need, and the
+/// CsvItem objects of the rows just refer to their row.
+/// The bytes of the text fields live in the arena of the columns, or in the arenas of the columns the rows were
+/// moved from, which are kept alive. So a table and its text are released as a whole.
+/// Rows are added, moved and reordered by CsvTable. Setters of different rows may be called in parallel, except
+/// for the text setters, which allocate in the arena.
+class CsvColumns
+{
+    std::shared_ptr<CsvArena> _arena{std::make_shared<CsvArena>()};
+    /// Arenas of moved rows, their text is still referenced
+    std::vector<std::shared_ptr<CsvArena>> _otherArenas{};
+    std::vector<CsvDate> _dates{};
+    std::vector<CsvSymbol> _types{};
+    std::vector<std::string_view> _payerPayees{};
+    std::vector<CsvSymbol> _accounts{};
+    std::vector<std::string_view> _descriptions{};
+    std::vector<CsvValue> _values{};
+    std::vector<CsvSymbol> _categories{};
+    std::vector<CsvSymbol> _files{};
+    std::vector<int> _lines{};
+
+    void KeepArenas(const CsvColumns& other);
+
+  public:
+    CsvColumns() = default;
+    ~CsvColumns() = default;
+
+    CsvColumns(const CsvColumns&) = delete;
+    CsvColumns& operator=(const CsvColumns&) = delete;
+    CsvColumns(CsvColumns&&) = delete;
+    CsvColumns& operator=(CsvColumns&&) = delete;
+
+    inline size_t GetSize() const
+    {
+        return _dates.size();
+    }
+
+    /// Arena of the CsvItem objects and the text of the rows (see CsvTable::AddItem())
+    inline const std::shared_ptr<CsvArena>& GetArena() const
+    {
+        return _arena;
+    }
+
+    void Reserve(size_t size);
+
+    /// Appends an empty row and returns its index
+    size_t AddRow();
+
+    /// Appends a copy of a row of other columns
+    size_t CopyRow(const CsvColumns& other, size_t row);
+
+    /// Appends a row of other columns, which are discarded afterwards
+    size_t MoveRow(CsvColumns& other, size_t row);
+
+    /// Appends all rows of other columns, which are empty afterwards
+    void Append(CsvColumns&& other);
+
+    void EraseRow(size_t row);
+
+    /// Removes the rows at the sorted, unique positions with one pass over the columns
+    void EraseRows(const std::vector<size_t>& rows);
+
+    /// Row i is the row order[i] before
+    void Reorder(const std::vector<size_t>& order);
+
+    /// Lower-cases the text fields of a row in place, like rules are matched
+    void ToLower(size_t row);
+
+    inline const CsvDate& GetDate(size_t row) const
+    {
+        return _dates[row];
+    }
+
+    /// -1 for rows without date
+    inline int GetYear(size_t row) const
+    {
+        return _dates[row].GetYear();
+    }
+
+    /// -1 for rows without date
+    inline int GetMonth(size_t row) const
+    {
+        return _dates[row].GetMonth();
+    }
+
+    inline CsvSymbol GetType(size_t row) const
+    {
+        return _types[row];
+    }
+
+    inline std::string_view GetPayerPayee(size_t row) const
+    {
+        return _payerPayees[row];
+    }
+
+    inline CsvSymbol GetAccount(size_t row) const
+    {
+        return _accounts[row];
+    }
+
+    inline std::string_view GetDescription(size_t row) const
+    {
+        return _descriptions[row];
+    }
+
+    inline const CsvValue& GetValue(size_t row) const
+    {
+        return _values[row];
+    }
+
+    inline CsvSymbol GetCategory(size_t row) const
+    {
+        return _categories[row];
+    }
+
+    inline CsvSymbol GetFile(size_t row) const
+    {
+        return _files[row];
+    }
+
+    inline int GetLine(size_t row) const
+    {
+        return _lines[row];
+    }
+
+    inline void SetDate(size_t row, const CsvDate& date)
+    {
+        _dates[row] = date;
+    }
+
+    inline void SetType(size_t row, CsvSymbol type)
+    {
+        _types[row] = type;
+    }
+
+    inline void SetPayerPayee(size_t row, std::string_view payerPayee)
+    {
+        _payerPayees[row] = _arena->AddText(payerPayee);
+    }
+
+    inline void SetAccount(size_t row, CsvSymbol account)
+    {
+        _accounts[row] = account;
+    }
+
+    inline void SetDescription(size_t row, std::string_view description)
+    {
+        _descriptions[row] = _arena->AddText(description);
+    }
+
+    inline void SetValue(size_t row, const CsvValue& value)
+    {
+        _values[row] = value;
+    }
+
+    inline void SetCategory(size_t row, CsvSymbol category)
+    {
+        _categories[row] = category;
+    }
+
+    inline void SetFile(size_t row, CsvSymbol file)
+    {
+        _files[row] = file;
+    }
+
+    inline void SetLine(size_t row, int line)
+    {
+        _lines[row] = line;
+    }
+};
+} // namespace hokee
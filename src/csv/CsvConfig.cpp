@@ -8,6 +8,8 @@
 
 #include <fmt/format.h>
 
+#include <fstream>
+
 namespace hokee
 {
 CsvConfig::CsvConfig(const std::unordered_map<std::string, std::string>& config, const fs::path& file)
@@ -30,7 +32,7 @@ CsvConfig::CsvConfig(const fs::path& file)
 
     for (auto& item : csvData)
     {
-        _config[item->Category] = item->Description;
+        _config[item->GetCategory().ToString()] = item->GetDescription();
     }
 }
 
@@ -1,5 +1,6 @@
 #include "csv/CsvDatabase.h"
 #include "InternalException.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 #include "csv/CsvDate.h"
 #include "csv/CsvItem.h"
@@ -10,152 +11,617 @@
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <exception>
 #include <functional>
-#include <future>
+#include <iterator>
 #include <memory>
+#include <numeric>
+#include <queue>
 #include <regex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace hokee
 {
+namespace
+{
+std::string GetRedefinitionIssue(int ruleId)
+{
+    return fmt::format("ERROR: Redefinition of rule {}", ruleId);
+}
+} // namespace
+
+CsvDatabase::CsvDatabase(ThreadPool& threadPool)
+    : _threadPool{threadPool}
+{
+}
+
 void CsvDatabase::Sort(CsvTable& csvData)
 {
-    auto compareDates = [](const CsvRowShared& i, const CsvRowShared& j) -> bool { return (i->Date < j->Date); };
-    std::sort(csvData.begin(), csvData.end(), compareDates);
+    if (csvData.size() < 2)
+    {
+        return;
+    }
+    if (csvData.size() > UINT32_MAX)
+    {
+        throw InternalException(__FILE__, __LINE__, fmt::format("Cannot sort {} rows.", csvData.size()));
+    }
+
+    // LSD radix sort of (date - minDate, row index) keys. Counting sort passes are stable, so rows of the same
+    // day keep their order. Only the digits which differ between minDate and maxDate need a pass.
+    int32_t minDate = INT32_MAX;
+    int32_t maxDate = INT32_MIN;
+    for (auto& row : csvData)
+    {
+        minDate = std::min(minDate, row->GetDate().ToInt());
+        maxDate = std::max(maxDate, row->GetDate().ToInt());
+    }
+    std::vector<uint64_t> keys(csvData.size());
+    for (size_t i = 0; i < csvData.size(); ++i)
+    {
+        keys[i] = static_cast<uint64_t>(csvData[i]->GetDate().ToInt() - minDate) << 32 | i;
+    }
+
+    constexpr int DIGIT_BITS = 11;
+    constexpr uint64_t DIGIT_MASK = (1 << DIGIT_BITS) - 1;
+    const uint64_t range = static_cast<uint64_t>(maxDate - minDate);
+    std::vector<uint64_t> buffer(keys.size());
+    std::vector<size_t> offsets(DIGIT_MASK + 1);
+    for (int shift = 32; (range >> (shift - 32)) != 0; shift += DIGIT_BITS)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint64_t key : keys)
+        {
+            ++offsets[(key >> shift) & DIGIT_MASK];
+        }
+        size_t offset = 0;
+        for (auto& count : offsets)
+        {
+            const size_t digitCount = count;
+            count = offset;
+            offset += digitCount;
+        }
+        for (uint64_t key : keys)
+        {
+            buffer[offsets[(key >> shift) & DIGIT_MASK]++] = key;
+        }
+        keys.swap(buffer);
+    }
+
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        order[i] = keys[i] & UINT32_MAX;
+    }
+    csvData.Reorder(order);
+}
+
+void CsvDatabase::SortRun(CsvTable& csvData)
+{
+    auto isEarlier = [](const CsvRowShared& i, const CsvRowShared& j) -> bool { return i->GetDate() < j->GetDate(); };
+    if (std::is_sorted(csvData.begin(), csvData.end(), isEarlier))
+    {
+        return;
+    }
+
+    auto isLater = [](const CsvRowShared& i, const CsvRowShared& j) -> bool { return j->GetDate() < i->GetDate(); };
+    if (std::is_sorted(csvData.begin(), csvData.end(), isLater))
+    {
+        // Reverse the days, but keep the order of the rows of each day
+        std::vector<size_t> order;
+        order.reserve(csvData.size());
+        for (size_t last = csvData.size(); last > 0;)
+        {
+            size_t first = last - 1;
+            while (first > 0 && csvData[first - 1]->GetDate() == csvData[last - 1]->GetDate())
+            {
+                --first;
+            }
+            for (size_t i = first; i < last; ++i)
+            {
+                order.push_back(i);
+            }
+            last = first;
+        }
+        csvData.Reorder(order);
+        return;
+    }
+
+    Sort(csvData);
+}
+
+void CsvDatabase::MergeRuns(std::vector<CsvTable>& runs, CsvTable& csvData)
+{
+    // Min heap of the next (date, run). Equal dates are taken from the earlier run first, like in a stable sort.
+    typedef std::pair<int32_t, size_t> RunHead;
+    std::priority_queue<RunHead, std::vector<RunHead>, std::greater<RunHead>> heads;
+    std::vector<size_t> positions(runs.size(), 0);
+    std::vector<size_t> offsets(runs.size(), 0);
+    size_t size = csvData.size();
+    for (size_t r = 0; r < runs.size(); ++r)
+    {
+        offsets[r] = size;
+        size += runs[r].size();
+        if (!runs[r].empty())
+        {
+            heads.emplace(runs[r].front()->GetDate().ToInt(), r);
+        }
+    }
+
+    // Merge the positions first, the rows and their columns are moved only once by Reorder()
+    std::vector<size_t> order(csvData.size());
+    std::iota(order.begin(), order.end(), 0);
+    order.reserve(size);
+    while (!heads.empty())
+    {
+        const size_t r = heads.top().second;
+        heads.pop();
+        const CsvTable& run = runs[r];
+        size_t& position = positions[r];
+
+        // Take all rows before the head of the next run at once
+        const RunHead next = heads.empty() ? RunHead(INT32_MAX, SIZE_MAX) : heads.top();
+        do
+        {
+            order.push_back(offsets[r] + position++);
+        } while (position < run.size() && RunHead(run[position]->GetDate().ToInt(), r) < next);
+
+        if (position < run.size())
+        {
+            heads.emplace(run[position]->GetDate().ToInt(), r);
+        }
+    }
+
+    for (auto& run : runs)
+    {
+        csvData.Append(std::move(run));
+    }
+    csvData.Reorder(order);
 }
 
 void CsvDatabase::CheckRules()
 {
     Utils::PrintInfo("Check rules...");
-    Issues.clear();
+    Issues.Clear();
+    std::vector<CsvRowShared> issues;
+    for (auto& row : Data)
+    {
+        if (CheckRow(*row))
+        {
+            issues.push_back(row);
+        }
+    }
+
+    std::unordered_map<std::string, std::vector<CsvItem*>> equalRules = GetEqualRules();
+    for (auto& rule : Rules)
+    {
+        if (CheckRule(*rule, equalRules[GetRuleKey(*rule)]))
+        {
+            issues.push_back(rule);
+        }
+    }
+    Issues.Append(std::move(issues));
+}
+
+bool CsvDatabase::CheckRow(CsvItem& row)
+{
+    row.Issues.clear();
+    for (auto& ref : row.References)
+    {
+        if (ref->GetCategory() != row.References[0]->GetCategory())
+        {
+            row.Issues.push_back("ERROR: Multiple rules with "
+                                 "different categories are matching");
+            break;
+        }
+    }
+    return !row.Issues.empty();
+}
+
+bool CsvDatabase::CheckRule(CsvItem& rule, const std::vector<CsvItem*>& equalRules)
+{
+    rule.Issues.clear();
+    if (rule.GetCategory().IsEmpty())
+    {
+        rule.Issues.push_back("ERROR: Category must not be empty!");
+    }
+
+    if (rule.References.size() == 0)
+    {
+        rule.Issues.push_back("ERROR: Rule does not match any item!");
+    }
+
+    bool isAlreadyCovered = true;
+    for (auto& ref : rule.References)
+    {
+        isAlreadyCovered = isAlreadyCovered && ref->References.size() > 1;
+    }
+    if (isAlreadyCovered)
+    {
+        rule.Issues.push_back("ERROR: Rule is redundant. (Matches are covered by other rules)!");
+    }
+
+    for (auto& other : equalRules)
+    {
+        if (&rule != other && rule == *other)
+        {
+            rule.Issues.push_back(GetRedefinitionIssue(other->Id));
+        }
+    }
+    return !rule.Issues.empty();
+}
+
+std::unordered_map<std::string, std::vector<CsvItem*>> CsvDatabase::GetEqualRules() const
+{
+    std::unordered_map<std::string, std::vector<CsvItem*>> equalRules;
+    for (auto& rule : Rules)
+    {
+        equalRules[GetRuleKey(*rule)].push_back(rule.get());
+    }
+    return equalRules;
+}
+
+std::string CsvDatabase::GetRuleKey(const CsvItem& rule)
+{
+    // Same fields as CsvItem::operator==
+    return fmt::format("{}\x1f{}\x1f{}\x1f{}\x1f{}\x1f{}\x1f{}", rule.GetDate().ToInt(),
+                       rule.GetType().GetId(), rule.GetPayerPayee(), rule.GetAccount().GetId(),
+                       rule.GetDescription(), rule.GetValue().IsEmpty(), rule.GetValue().GetCents());
+}
 
+void CsvDatabase::UpdateAssignments()
+{
+    std::vector<CsvRowShared> assigned;
+    std::vector<CsvRowShared> unassigned;
     for (auto& row : Data)
     {
-        if (row->References.size() > 1)
+        if (row->References.size() == 0)
         {
-            for (auto& ref : row->References)
-            {
-                if (ref->Category != row->References[0]->Category)
-                {
-                    row->Issues.push_back("ERROR: Multiple rules with "
-                                          "different categories are matching");
-                    Issues.push_back(row);
-                    break;
-                }
-            }
+            unassigned.push_back(row);
+        }
+        else
+        {
+            assigned.push_back(row);
         }
     }
+    Assigned.Clear();
+    Assigned.Append(std::move(assigned));
+    Unassigned.Clear();
+    Unassigned.Append(std::move(unassigned));
+}
 
-    for (auto& rule1 : Rules)
+void CsvDatabase::SetCategory(CsvItem& row, CsvSymbol category)
+{
+    const CsvSymbol previous = row.GetCategory();
+    if (category != previous)
     {
-        if (rule1->Category.empty())
+        _summary.Move(row.GetDate().GetYear(), row.GetDate().GetMonth(), row.GetValue().GetCents(), previous,
+                      category);
+        row.SetCategory(category);
+    }
+}
+
+void CsvDatabase::CompileRules()
+{
+    // Compile before releasing the old rules, so unchanged patterns are taken from the cache
+    std::vector<CsvRule> compiledRules;
+    compiledRules.reserve(Rules.size());
+    for (auto& rule : Rules)
+    {
+        compiledRules.emplace_back(*rule, _patterns);
+    }
+    _compiledRules = std::move(compiledRules);
+    _patterns.Prune();
+}
+
+void CsvDatabase::UnlinkRule(CsvItem& rule)
+{
+    for (auto& row : rule.References)
+    {
+        auto& refs = row->References;
+        refs.erase(std::remove(refs.begin(), refs.end(), &rule), refs.end());
+        if (!refs.empty())
         {
-            if (rule1->Issues.size() == 0)
-            {
-                Issues.push_back(rule1);
-            }
-            rule1->Issues.push_back("ERROR: Category must not be empty!");
+            SetCategory(*row, refs.back()->GetCategory());
+        }
+    }
+    rule.References.clear();
+}
+
+void CsvDatabase::MatchRule(int id)
+{
+    const size_t ruleIndex = Rules.FindPosition(id);
+    if (ruleIndex == SIZE_MAX)
+    {
+        throw InternalException(__FILE__, __LINE__, fmt::format("Could not find rule id {}", id));
+    }
+    auto& rule = Rules[ruleIndex];
+
+    // Compile only this rule, a new rule (see NewRule()) is the last one
+    rule->ToLower();
+    if (_compiledRules.size() == Rules.size() && &_compiledRules[ruleIndex].GetItem() == rule.get())
+    {
+        _compiledRules[ruleIndex] = CsvRule(*rule, _patterns);
+        _patterns.Prune();
+    }
+    else if (_compiledRules.size() + 1 == Rules.size() && ruleIndex + 1 == Rules.size())
+    {
+        _compiledRules.emplace_back(*rule, _patterns);
+    }
+    else
+    {
+        CompileRules();
+    }
+    const CsvRule& compiledRule = _compiledRules[ruleIndex];
+
+    // Only the old matches of the rule and the rows which may match it now can change
+    std::vector<size_t> candidates = GetCandidates(compiledRule);
+    for (const CsvItem* row : rule->References)
+    {
+        candidates.push_back(row->GetRow());
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    const CsvColumns& columns = Data.GetColumns();
+    std::vector<CsvItem*> references;
+    std::vector<CsvItem*> rows;
+    for (size_t r : candidates)
+    {
+        CsvItem& row = *Data[r];
+        auto& refs = row.References;
+        auto ref = std::find(refs.begin(), refs.end(), rule.get());
+        const bool wasMatch = ref != refs.end();
+        const bool isMatch = compiledRule.Match(columns, r);
+        if (!wasMatch && !isMatch)
+        {
+            continue;
         }
 
-        if (rule1->References.size() == 0)
+        if (!wasMatch)
         {
-            if (rule1->Issues.size() == 0)
+            // Keep the references of a row in rule order (the last one defines the category)
+            auto isAfterCallback = [&](const CsvItem* other)
             {
-                Issues.push_back(rule1);
-            }
-            rule1->Issues.push_back("ERROR: Rule does not match any item!");
+                return Rules.FindPosition(other->Id) > ruleIndex;
+            };
+            refs.insert(std::find_if(refs.begin(), refs.end(), isAfterCallback), rule.get());
+        }
+        else if (!isMatch)
+        {
+            refs.erase(ref);
+        }
+        if (isMatch)
+        {
+            references.push_back(&row);
         }
 
-        bool isAlreadyCovered = true;
-        for (auto& ref : rule1->References)
+        // The category of the rule may have changed as well
+        if (!refs.empty())
         {
-            isAlreadyCovered = isAlreadyCovered && ref->References.size() > 1;
+            SetCategory(row, refs.back()->GetCategory());
         }
-        if (isAlreadyCovered)
+        rows.push_back(&row);
+    }
+    rule->References = std::move(references);
+
+    UpdateRows(rows, id);
+}
+
+void CsvDatabase::UpdateRows(const std::vector<CsvItem*>& rows, int ruleId)
+{
+    // Rules whose issues may change: the rule, its old and new redefinitions and the rules of the rows
+    std::vector<CsvItem*> rules;
+    if (const CsvRowShared rule = Rules.FindItem(ruleId))
+    {
+        rules.push_back(rule.get());
+    }
+    const std::string redefinition = GetRedefinitionIssue(ruleId);
+    for (auto& issue : Issues)
+    {
+        if (std::find(issue->Issues.begin(), issue->Issues.end(), redefinition) != issue->Issues.end())
         {
-            if (rule1->Issues.size() == 0)
-            {
-                Issues.push_back(rule1);
-            }
-            rule1->Issues.push_back("ERROR: Rule is redundant. (Matches are covered by other rules)!");
+            rules.push_back(issue.get());
         }
+    }
+    std::unordered_map<std::string, std::vector<CsvItem*>> equalRules = GetEqualRules();
+    const size_t changedRuleCount = rules.size();
+    for (size_t r = 0; r < changedRuleCount; ++r)
+    {
+        const std::vector<CsvItem*>& equal = equalRules[GetRuleKey(*rules[r])];
+        rules.insert(rules.end(), equal.begin(), equal.end());
+    }
 
-        for (auto& rule2 : Rules)
+    // Rows and rules which are added to or removed from the tables
+    std::vector<CsvRowShared> assigned;
+    std::vector<CsvRowShared> unassigned;
+    std::vector<CsvRowShared> issues;
+    std::vector<int> removedAssigned;
+    std::vector<int> removedUnassigned;
+    std::vector<int> removedIssues;
+    auto updateCallback = [](const CsvRowShared& item, bool isIncluded, const CsvTable& table,
+                     std::vector<CsvRowShared>& added, std::vector<int>& removed)
+    {
+        if (isIncluded && !table.HasItem(item->Id))
         {
-            if (rule1.get() != rule2.get() && *rule1 == *rule2)
-            {
-                if (rule1->Issues.size() == 0)
-                {
-                    Issues.push_back(rule1);
-                }
-                rule1->Issues.push_back(fmt::format("ERROR: Redefinition of rule {}", rule2->Id));
-            }
+            added.push_back(item);
+        }
+        else if (!isIncluded && table.HasItem(item->Id))
+        {
+            removed.push_back(item->Id);
+        }
+    };
+
+    for (CsvItem* row : rows)
+    {
+        const CsvRowShared item = Data.FindItem(row->Id);
+        updateCallback(item, !row->References.empty(), Assigned, assigned, removedAssigned);
+        updateCallback(item, row->References.empty(), Unassigned, unassigned, removedUnassigned);
+        updateCallback(item, CheckRow(*row), Issues, issues, removedIssues);
+        rules.insert(rules.end(), row->References.begin(), row->References.end());
+    }
+    std::sort(rules.begin(), rules.end());
+    rules.erase(std::unique(rules.begin(), rules.end()), rules.end());
+    for (CsvItem* rule : rules)
+    {
+        updateCallback(Rules.FindItem(rule->Id), CheckRule(*rule, equalRules[GetRuleKey(*rule)]), Issues, issues,
+                       removedIssues);
+    }
+
+    // The tables keep the order of Data, Issues lists the rows before the rules
+    Assigned.DeleteItems(removedAssigned);
+    Unassigned.DeleteItems(removedUnassigned);
+    Issues.DeleteItems(removedIssues);
+    auto dataOrderCallback = [](const CsvRowShared& a, const CsvRowShared& b)
+    {
+        return a->GetRow() < b->GetRow();
+    };
+    Assigned.Insert(std::move(assigned), dataOrderCallback);
+    Unassigned.Insert(std::move(unassigned), dataOrderCallback);
+    const CsvColumns* ruleColumns = &Rules.GetColumns();
+    auto issueOrderCallback = [ruleColumns](const CsvRowShared& a, const CsvRowShared& b)
+    {
+        return std::make_pair(&a->GetColumns() == ruleColumns, a->GetRow())
+               < std::make_pair(&b->GetColumns() == ruleColumns, b->GetRow());
+    };
+    Issues.Insert(std::move(issues), issueOrderCallback);
+}
+
+std::vector<size_t> CsvDatabase::GetCandidates(const CsvRule& rule) const
+{
+    // Every row which matches contains the required literals of all patterns
+    std::string_view literal;
+    for (const CsvPattern* pattern : {rule.GetPayerPayeePattern(), rule.GetDescriptionPattern(), rule.GetTypePattern(),
+                                      rule.GetAccountPattern()})
+    {
+        if (pattern && pattern->GetRequiredLiteral().size() > literal.size())
+        {
+            literal = pattern->GetRequiredLiteral();
         }
     }
+    return _textIndex.GetCandidates(Data.GetColumns(), literal);
 }
 
-std::vector<std::string> CsvDatabase::GetCategories() const
+std::vector<CsvSymbol> CsvDatabase::GetCategories() const
 {
-    std::vector<std::string> categories;
+    std::vector<CsvSymbol> categories;
     for (auto& rule : Rules)
     {
-        if (std::find(categories.begin(), categories.end(), rule->Category) == categories.end())
+        if (std::find(categories.begin(), categories.end(), rule->GetCategory()) == categories.end())
         {
-            categories.push_back(rule->Category);
+            categories.push_back(rule->GetCategory());
         }
     }
-    std::sort(categories.begin(), categories.end());
+    std::sort(categories.begin(), categories.end(),
+              [](const CsvSymbol& a, const CsvSymbol& b) { return a.ToString() < b.ToString(); });
     return categories;
 }
 
-int CsvDatabase::DeleteRule(int id)
+std::vector<CsvRowShared> CsvDatabase::GetItems(int year, int month, const std::string& category,
+                                                int filter) const
 {
-    Data.DeleteItem(id);
-    Assigned.DeleteItem(id);
-    Unassigned.DeleteItem(id);
-    Issues.DeleteItem(id);
-    return Rules.DeleteItem(id);
+    // Categories which were never interned cannot match any item
+    CsvSymbol symbol{};
+    const bool isKnownCategory = CsvSymbol::Find(category, symbol);
+
+    const CsvColumns& columns = Data.GetColumns();
+    std::vector<CsvRowShared> items{};
+    for (size_t r = 0; r < columns.GetSize(); ++r)
+    {
+        if (year == columns.GetYear(r) && (month == 0 || month == columns.GetMonth(r))
+            && (category.empty() || (isKnownCategory && symbol == columns.GetCategory(r))))
+        {
+            const int64_t value = columns.GetValue(r).GetCents();
+            if (filter == 0 || (filter < 0 && value < 0) || (filter > 0 && value >= 0))
+            {
+                items.push_back(Data[r]);
+            }
+        }
+    }
+    return items;
 }
 
-int CsvDatabase::NewRule(int itemId)
+std::vector<CsvRowShared> CsvDatabase::Search(const std::vector<CsvRowShared>& rows, std::string_view query) const
 {
-    std::shared_ptr<CsvItem> item = nullptr;
-    for (auto& i : Data)
+    std::vector<CsvRowShared> result;
+    if (&rows == &Rules.GetRows() || &rows == &Issues.GetRows())
+    {
+        const std::vector<std::string> words = CsvTextIndex::SplitQuery(query);
+        std::copy_if(rows.begin(), rows.end(), std::back_inserter(result),
+                     [&](const CsvRowShared& row) { return CsvTextIndex::Match(*row, words); });
+        return result;
+    }
+
+    const std::vector<size_t> positions = _textIndex.Find(Data.GetColumns(), GetCategories(), query);
+    if (&rows == &Data.GetRows())
     {
-        if (i->Id == itemId)
+        result.reserve(positions.size());
+        for (size_t r : positions)
         {
-            item = i;
-            break;
+            result.push_back(Data[r]);
         }
+        return result;
+    }
+
+    // Other tables (e.g. Assigned or the rows of an items page) keep their order
+    std::unordered_set<const CsvItem*> matches;
+    matches.reserve(positions.size());
+    for (size_t r : positions)
+    {
+        matches.insert(Data[r].get());
     }
+    std::copy_if(rows.begin(), rows.end(), std::back_inserter(result),
+                 [&](const CsvRowShared& row) { return matches.count(row.get()) > 0; });
+    return result;
+}
+
+int CsvDatabase::DeleteRule(int id)
+{
+    std::vector<CsvItem*> rows;
+    if (const CsvRowShared rule = Rules.FindItem(id))
+    {
+        rows = rule->References;
+        UnlinkRule(*rule);
+        _compiledRules.erase(std::remove_if(_compiledRules.begin(), _compiledRules.end(),
+                                            [&](const CsvRule& r) { return &r.GetItem() == rule.get(); }),
+                             _compiledRules.end());
+    }
+    Issues.DeleteItem(id);
+    const int nextId = Rules.DeleteItem(id);
+
+    UpdateRows(rows, id);
+    return nextId;
+}
+
+int CsvDatabase::NewRule(int itemId)
+{
+    std::shared_ptr<CsvItem> item = Data.FindItem(itemId);
     if (!item)
     {
         throw InternalException(__FILE__, __LINE__, fmt::format("Could not find item id {}", itemId));
     }
 
-    CsvRowShared newRule = std::make_shared<CsvItem>(*item);
-
-    newRule->Id = Utils::GenerateId();
-    newRule->Date = {};
-    newRule->Value = {};
-    newRule->Account = {};
-    newRule->Issues.clear();
-    newRule->File = "???";
-    newRule->Line = -1;
-    newRule->References.clear();
+    const CsvRowShared& newRule = Rules.AddItem(*item, Utils::GenerateId());
+    newRule->SetDate({});
+    newRule->SetValue({});
+    newRule->SetAccount({});
+    newRule->SetFile("???");
+    newRule->SetLine(-1);
     newRule->References.push_back(item.get());
 
-    Rules.push_back(newRule);
-
     return newRule->Id;
 }
 
 void CsvDatabase::LoadRules(const fs::path& ruleSetFile)
 {
     std::unique_ptr<CsvParser> csvReader;
-    csvReader = std::make_unique<CsvParser>(ruleSetFile, CsvRules::GetFormat());
+    csvReader = std::make_unique<CsvParser>(ruleSetFile, CsvRules::GetFormat(), _threadPool);
     csvReader->Load(Rules);
+    Rules.GenerateIds();
 }
 
 void CsvDatabase::MatchRules()
@@ -163,102 +629,81 @@ void CsvDatabase::MatchRules()
     // Clear rules
     for (auto& row : Data)
     {
-        row->Issues.clear();
         row->References.clear();
     }
-    Assigned.clear();
-    Unassigned.clear();
 
-    // Prepare rules
+    // Prepare rules (only new or changed patterns are compiled)
+    const size_t compileCount = _patterns.GetCompileCount();
     for (auto& rule : Rules)
     {
         rule->ToLower();
-        rule->UpdateRegex();
 
         // reset
-        rule->Issues.clear();
         rule->References.clear();
     }
+    CompileRules();
+    Utils::PrintInfo(fmt::format("Compiled {} of {} patterns", _patterns.GetCompileCount() - compileCount,
+                                 _patterns.GetSize()));
 
-    auto matchRulesToRowCallback = [this](const uint64_t r0, const uint64_t ri)
+    _ruleFilter.Build(_compiledRules);
+
+    // Every chunk of rows collects its (row, rule) matches separately, they are linked after the parallel phase
+    CsvColumns& columns = Data.GetColumns();
+    const size_t chunkSize = std::max<size_t>(1, Data.size() / (_threadPool.GetThreadCount() * 8));
+    std::vector<std::vector<std::pair<CsvItem*, CsvItem*>>> matches((Data.size() + chunkSize - 1) / chunkSize);
+    auto matchRulesCallback = [&](size_t begin, size_t end)
     {
-        for (uint64_t r = r0; r < Data.size(); r += ri)
+        auto& chunkMatches = matches[begin / chunkSize];
+        std::vector<size_t> candidates;
+        for (size_t r = begin; r < end; ++r)
         {
-            auto& row = Data[r];
-            row->ToLower();
+            columns.ToLower(r);
 
-            for (auto& rule : Rules)
+            _ruleFilter.GetCandidates(columns, r, candidates);
+            for (size_t candidate : candidates)
             {
-                row->Match(rule);
+                const CsvRule& rule = _compiledRules[candidate];
+                if (rule.Match(columns, r))
+                {
+                    chunkMatches.emplace_back(Data[r].get(), &rule.GetItem());
+                }
             }
         }
     };
+    _threadPool.ParallelFor("Match rules", Data.size(), matchRulesCallback, chunkSize);
 
-    const uint64_t threadCount = std::thread::hardware_concurrency();
-    Utils::PrintInfo(fmt::format("Match rules... (with {} threads)", threadCount));
-    std::vector<std::future<void>> matchRulesFutures(threadCount);
-    for (uint64_t f = 0; f < matchRulesFutures.size(); ++f)
+    // Rows and rules reference each other in the order of Rules and Data
+    for (auto& chunkMatches : matches)
     {
-        matchRulesFutures[f] = std::async(std::launch::async, matchRulesToRowCallback, f, threadCount);
-    }
-
-    for (uint64_t f = 0; f < matchRulesFutures.size(); ++f)
-    {
-        matchRulesFutures[f].get();
-    }
-
-    // Apply rules
-    for (auto& row : Data)
-    {
-        if (row->References.size() == 0)
+        for (auto& [row, rule] : chunkMatches)
         {
-            Unassigned.push_back(row);
-        }
-        else
-        {
-            Assigned.push_back(row);
+            row->References.push_back(rule);
+            rule->References.push_back(row);
+            row->SetCategory(rule->GetCategory());
         }
     }
+    _summary.Build(Data.GetColumns());
 
+    // Apply rules
+    UpdateAssignments();
     CheckRules();
 }
 
 void CsvDatabase::Load(const fs::path& inputDirectory, const fs::path& ruleSetFile)
 {
     // Clear
-    Data.clear();
-    Unassigned.clear();
-    Assigned.clear();
-    Rules.clear();
-    Issues.clear();
-
-    // detect number of file
-    ProgressMax = 0;
-    for (const auto& dir : fs::directory_iterator(inputDirectory))
-    {
-        if (fs::is_directory(dir))
-        {
-            if (dir.path().filename().string().rfind(".", 0) == 0)
-            {
-                // Utils::PrintInfo(fmt::format("Skip hidden directory '{}':", dir.path().string()));
-                continue;
-            }
-
-            if (fs::is_empty(dir.path()))
-            {
-                // Utils::PrintInfo(fmt::format("Skip empty directory '{}':", dir.path().string()));
-                continue;
-            }
-
-            for (const auto& file : fs::directory_iterator(dir.path()))
-            {
-                std::ignore = file;
-                ProgressMax++;
-            }
-        }
-    }
-
-    ProgressValue = 0;
+    Data.Clear();
+    Unassigned.Clear();
+    Assigned.Clear();
+    Rules.Clear();
+    Issues.Clear();
+    _compiledRules.clear();
+    _summary.Build(Data.GetColumns());
+    _textIndex.Build(Data.GetColumns());
+
+    // Collect files and load formats once per directory
+    std::vector<CsvFormat> formats;
+    std::vector<std::pair<fs::path, size_t>> files;
     for (const auto& dir : fs::directory_iterator(inputDirectory))
     {
         if (fs::is_directory(dir))
@@ -280,29 +725,69 @@ void CsvDatabase::Load(const fs::path& inputDirectory, const fs::path& ruleSetFi
             {
                 throw UserException(fmt::format("Could not find format description file"), formatFile);
             }
-            CsvFormat format(formatFile);
+            formats.emplace_back(formatFile);
 
             for (const auto& file : fs::directory_iterator(dir.path()))
             {
-                ProgressValue++;
                 if (!fs::is_regular_file(file) || Utils::ToLower(file.path().filename().string()) == "format.ini")
                 {
                     continue;
                 }
-                Utils::PrintInfo(
-                    fmt::format("Parse '{}' {}/{}...", file.path().string(), ProgressValue, ProgressMax));
+                files.emplace_back(file.path(), formats.size() - 1);
+            }
+        }
+    }
+
+    ProgressMax = files.size();
+    ProgressValue = 0;
 
-                std::unique_ptr<CsvParser> csvReader;
-                csvReader = std::make_unique<CsvParser>(file.path(), format);
-                csvReader->Load(Data);
+    // Parse files in parallel, one file per task
+    std::vector<CsvTable> tables(files.size());
+    std::vector<std::exception_ptr> errors(files.size());
+    auto parseFilesCallback = [&](size_t begin, size_t end)
+    {
+        for (size_t f = begin; f < end; ++f)
+        {
+            try
+            {
+                CsvParser csvReader(files[f].first, formats[files[f].second], _threadPool);
+                csvReader.Load(tables[f]);
+            }
+            catch (...)
+            {
+                errors[f] = std::current_exception();
             }
+            Utils::PrintInfo(
+                fmt::format("Parsed '{}' {}/{}", files[f].first.string(), ++ProgressValue, ProgressMax));
         }
+    };
+    _threadPool.ParallelFor("Parse files", files.size(), parseFilesCallback, 1);
+
+    // Ids in directory order, so they and the order of equal dates do not depend on thread timing
+    for (size_t f = 0; f < files.size(); ++f)
+    {
+        if (errors[f])
+        {
+            std::rethrow_exception(errors[f]);
+        }
+        tables[f].GenerateIds();
     }
 
-    Sort(Data);
+    // Bank exports are mostly sorted by date already, so only unsorted files need a sort before the merge
+    auto sortFilesCallback = [&](size_t begin, size_t end)
+    {
+        for (size_t f = begin; f < end; ++f)
+        {
+            SortRun(tables[f]);
+        }
+    };
+    _threadPool.ParallelFor("Sort files", tables.size(), sortFilesCallback, 1);
+    MergeRuns(tables, Data);
     LoadRules(ruleSetFile);
 
     MatchRules();
+    _textIndex.Build(Data.GetColumns());
+    Utils::PrintInfo(fmt::format("Indexed {} trigrams", _textIndex.GetTrigramCount()));
     Utils::PrintInfo("Finished loading.");
 }
 } // namespace hokee
\ No newline at end of file
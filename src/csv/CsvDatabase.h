@@ -1,11 +1,20 @@
 #pragma once
 
+#include "csv/CsvColumns.h"
 #include "csv/CsvParser.h"
+#include "csv/CsvPatternCache.h"
+#include "csv/CsvRule.h"
+#include "csv/CsvRuleFilter.h"
 #include "csv/CsvRules.h"
+#include "csv/CsvSummary.h"
+#include "csv/CsvTextIndex.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 
 #include <array>
 #include <atomic>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace hokee
@@ -13,9 +22,39 @@ namespace hokee
 
 class CsvDatabase
 {
+    ThreadPool& _threadPool;
+    CsvPatternCache _patterns{};
+    std::vector<CsvRule> _compiledRules{};
+    CsvRuleFilter _ruleFilter{};
+    CsvSummary _summary{};
+    CsvTextIndex _textIndex{};
+
     void LoadRules(const fs::path& ruleSetFile);
     void CheckRules();
-    void Sort(CsvTable& csvData);
+    void CompileRules();
+    void UpdateAssignments();
+    void UnlinkRule(CsvItem& rule);
+
+    /// Updates Assigned, Unassigned and Issues after the references between the rows and the rule with this id
+    /// changed (edited, new or deleted rule). Only the rows, the rules referenced by them and the redefinitions of
+    /// the rule are checked, not all rows like UpdateAssignments() and CheckRules().
+    void UpdateRows(const std::vector<CsvItem*>& rows, int ruleId);
+
+    /// Rows of Data which may match the rule: the text index rows of the longest required literal of its patterns
+    std::vector<size_t> GetCandidates(const CsvRule& rule) const;
+
+    /// Sets the category of a row of Data and moves it to the summary cells of the new category
+    void SetCategory(CsvItem& row, CsvSymbol category);
+    static std::string GetRuleKey(const CsvItem& rule);
+
+    /// Rules grouped by GetRuleKey(), to find redefinitions without comparing all pairs of rules
+    std::unordered_map<std::string, std::vector<CsvItem*>> GetEqualRules() const;
+
+    /// Sets the issues of a row of Data, true if there are any
+    static bool CheckRow(CsvItem& row);
+
+    /// Sets the issues of a rule, equalRules are the rules with its GetRuleKey(). True if there are any.
+    static bool CheckRule(CsvItem& rule, const std::vector<CsvItem*>& equalRules);
 
   public:
     CsvTable Data{};
@@ -25,7 +64,7 @@ class CsvDatabase
     CsvRules Rules{};
     CsvTable Issues{};
 
-    CsvDatabase() = default;
+    explicit CsvDatabase(ThreadPool& threadPool = ThreadPool::GetInstance());
     ~CsvDatabase() = default;
 
     CsvDatabase(const CsvDatabase&) = delete;
@@ -35,9 +74,37 @@ class CsvDatabase
 
     void Load(const fs::path& inputDirectory, const fs::path& ruleSetFile);
     void MatchRules();
+
+    /// Re-matches only the rule with the given id after it was changed or created
+    void MatchRule(int id);
     int NewRule(int id);
+
+    /// Deletes the rule and updates the affected items (no MatchRules() required)
     int DeleteRule(int id);
-    std::vector<std::string> GetCategories() const;
+    /// Categories of all rules, sorted by name
+    std::vector<CsvSymbol> GetCategories() const;
+
+    /// Rows which contain every word of the query in PayerPayee, Description, Type, Account or Category
+    /// (case-insensitive). Data and its subsets are searched with the text index, Rules and Issues are scanned.
+    std::vector<CsvRowShared> Search(const std::vector<CsvRowShared>& rows, std::string_view query) const;
+
+    /// Stable sort by date, rows of the same day keep their order
+    static void Sort(CsvTable& csvData);
+
+    /// Same result as Sort(), but ascending and descending tables are only checked or reversed
+    static void SortRun(CsvTable& csvData);
+
+    /// Appends the rows of the runs sorted by SortRun() to csvData, same result as Sort() of the concatenated runs
+    static void MergeRuns(std::vector<CsvTable>& runs, CsvTable& csvData);
+
+    /// Rows of an items page: year, month (0: all), category ("": all) and sign of the value (filter: -1, 0, +1)
+    std::vector<CsvRowShared> GetItems(int year, int month, const std::string& category, int filter) const;
+
+    /// Sums of the summary page, up to date after every rule change
+    inline const CsvSummary& GetSummary() const
+    {
+        return _summary;
+    }
     
     std::atomic<size_t> ProgressMax{100};
     std::atomic<size_t> ProgressValue{0};
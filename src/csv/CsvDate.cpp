@@ -2,153 +2,165 @@
 #include "InternalException.h"
 #include "Utils.h"
 
+#include <array>
 #include <cstdint>
 #include <fmt/format.h>
 
 namespace hokee
 {
+namespace
+{
+/// Positions of the fields in a date string. Other characters than 'd', 'm' and 'y' are separators.
+struct Layout
+{
+    std::string_view Format;
+    size_t Day;
+    size_t Month;
+    size_t Year;
+    size_t YearDigits;
+};
+
+/// Indexed by CsvDate::Format
+constexpr std::array<Layout, 6> LAYOUTS = {{{"dd.mm.yy", 0, 3, 6, 2},
+                                            {"dd.mm.yyyy", 0, 3, 6, 4},
+                                            {"yyyy-mm-dd", 8, 5, 0, 4},
+                                            {"mm/dd/yyyy", 3, 0, 6, 4},
+                                            {"dd/mm/yyyy", 0, 3, 6, 4},
+                                            {"yyyymmdd", 6, 4, 0, 4}}};
+
+int ParseNumber(std::string_view dateStr, size_t pos, size_t count)
+{
+    int number = 0;
+    for (size_t i = pos; i < pos + count; ++i)
+    {
+        const char c = dateStr[i];
+        if (c < '0' || c > '9')
+        {
+            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'.", dateStr.substr(pos, count)));
+        }
+        number = number * 10 + (c - '0');
+    }
+    return number;
+}
+} // namespace
+
+CsvDate::CsvDate(int32_t date, Format format)
+    : _date{date}
+    , _format{format}
+{
+}
+
 CsvDate::CsvDate(std::string_view formatStr, std::string_view dateStr)
-: _formatStr{formatStr}
 {
+    // Without a date an unsupported format does not matter
     if (dateStr.empty())
     {
+        FindFormat(formatStr, _format);
         return;
     }
+    *this = GetParser(formatStr)(dateStr);
+}
+
+template <CsvDate::Format F>
+CsvDate CsvDate::Parse(std::string_view dateStr)
+{
+    static_assert(LAYOUTS.size() == FORMAT_COUNT);
+    constexpr Layout layout = LAYOUTS[F];
 
-    if (formatStr.size() != dateStr.size())
+    if (dateStr.empty())
+    {
+        return CsvDate(0, F);
+    }
+    if (dateStr.size() != layout.Format.size())
     {
         throw std::runtime_error(
             fmt::format("Could not parse date string. Format string '{}' does not match date string '{}'.",
-                        formatStr, dateStr));
+                        layout.Format, dateStr));
     }
-    if (formatStr == "dd.mm.yy")
+    for (size_t i = 0; i < layout.Format.size(); ++i)
     {
-        const std::string_view dayStr = dateStr.substr(0, 2);
-        try
-        {
-            _day = std::stoi(std::string(dayStr.data(), dayStr.size()));
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'. ({})", dayStr, e.what()));
-        }
-
-        const std::string_view monthStr = dateStr.substr(3, 2);
-        try
-        {
-            _month = std::stoi(std::string(monthStr.data(), monthStr.size()));
-        }
-        catch (const std::exception& e)
+        const char c = layout.Format[i];
+        if (c != 'd' && c != 'm' && c != 'y' && c != dateStr[i])
         {
-            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'. ({})", monthStr, e.what()));
-        }
-
-        const std::string_view yearStr = dateStr.substr(6, 2);
-        try
-        {
-            _year = std::stoi(std::string(yearStr.data(), yearStr.size()));
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'. ({})", yearStr, e.what()));
-        }
-
-        if (_year >= 70)
-        {
-            _year += 1900;
-        }
-        else
-        {
-            _year += 2000;
+            throw std::runtime_error(
+                fmt::format("Could not parse date string. Format string '{}' does not match date string '{}'.",
+                            layout.Format, dateStr));
         }
     }
-    else if (formatStr == "dd.mm.yyyy")
-    {
-        const std::string_view dayStr = dateStr.substr(0, 2);
-        try
-        {
-            _day = std::stoi(std::string(dayStr.data(), dayStr.size()));
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'. ({})", dayStr, e.what()));
-        }
-
-        const std::string_view monthStr = dateStr.substr(3, 2);
-        try
-        {
-            _month = std::stoi(std::string(monthStr.data(), monthStr.size()));
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'. ({})", monthStr, e.what()));
-        }
 
-        const std::string_view yearStr = dateStr.substr(6, 4);
-        try
-        {
-            _year = std::stoi(std::string(yearStr.data(), yearStr.size()));
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(fmt::format("Could not convert '{}' to 'int'. ({})", yearStr, e.what()));
-        }
-    }
-    else
+    const int day = ParseNumber(dateStr, layout.Day, 2);
+    const int month = ParseNumber(dateStr, layout.Month, 2);
+    int year = ParseNumber(dateStr, layout.Year, layout.YearDigits);
+    if constexpr (layout.YearDigits == 2)
     {
-        throw UserException(fmt::format("Could not parse date string. Unsupported format string \"{}\" "
-                                        "(Supported formats: \"dd.mm.yy\", \"dd.mm.yyyy\")",
-                                        formatStr));
+        year += year >= 70 ? 1900 : 2000;
     }
 
-    _dateStr = fmt::format("{:#02}.{:#02}.{:#04}", _day, _month, _year);
+    if (day < 1 || day > 31 || month < 1 || month > 12 || year < 1)
+    {
+        throw std::runtime_error(fmt::format("Invalid date '{}'.", dateStr));
+    }
+    return CsvDate(year * 10000 + month * 100 + day, F);
 }
 
-const std::string& CsvDate::ToString() const
+bool CsvDate::FindFormat(std::string_view formatStr, Format& format)
 {
-    return _dateStr;
+    for (size_t f = 0; f < LAYOUTS.size(); ++f)
+    {
+        if (LAYOUTS[f].Format == formatStr)
+        {
+            format = static_cast<Format>(f);
+            return true;
+        }
+    }
+    return false;
 }
 
-bool CsvDate::operator==(const CsvDate& rhs) const
+CsvDate::Parser CsvDate::GetParser(std::string_view formatStr)
 {
-    return (_day == rhs._day) && (_month == rhs._month) && (_year == rhs._year);
+    static constexpr std::array<Parser, FORMAT_COUNT> parsers = {
+        &Parse<DD_MM_YY_DOTS>,      &Parse<DD_MM_YYYY_DOTS>,    &Parse<YYYY_MM_DD_DASHES>,
+        &Parse<MM_DD_YYYY_SLASHES>, &Parse<DD_MM_YYYY_SLASHES>, &Parse<YYYYMMDD>};
+
+    Format format{};
+    if (!FindFormat(formatStr, format))
+    {
+        std::string supported;
+        for (const Layout& layout : LAYOUTS)
+        {
+            supported += fmt::format("{}\"{}\"", supported.empty() ? "" : ", ", layout.Format);
+        }
+        throw UserException(fmt::format(
+            "Could not parse date string. Unsupported format string \"{}\" (Supported formats: {})", formatStr,
+            supported));
+    }
+    return parsers[format];
 }
 
-bool CsvDate::operator!=(const CsvDate& rhs) const
+std::string CsvDate::GetFormat() const
 {
-    return !(*this == rhs);
+    return std::string(LAYOUTS[_format].Format);
 }
 
-bool CsvDate::operator<(const CsvDate& other) const
+std::string CsvDate::ToString() const
 {
-    if (_year < other._year)
-    {
-        return true;
-    }
-    if (_year > other._year)
-    {
-        return false;
-    }
-
-    if (_month < other._month)
+    if (IsEmpty())
     {
-        return true;
+        return {};
     }
-    if (_month > other._month)
-    {
-        return false;
-    }
-
-    if (_day < other._day)
-    {
-        return true;
-    }
-    if (_day > other._day)
-    {
-        return false;
-    }
-
-    return false;
+    std::string str = "dd.mm.yyyy";
+    const int day = GetDay();
+    const int month = GetMonth();
+    const int year = GetYear();
+    str[0] = static_cast<char>('0' + day / 10);
+    str[1] = static_cast<char>('0' + day % 10);
+    str[3] = static_cast<char>('0' + month / 10);
+    str[4] = static_cast<char>('0' + month % 10);
+    str[6] = static_cast<char>('0' + year / 1000);
+    str[7] = static_cast<char>('0' + year / 100 % 10);
+    str[8] = static_cast<char>('0' + year / 10 % 10);
+    str[9] = static_cast<char>('0' + year % 10);
+    return str;
 }
 
 std::ostream& operator<<(std::ostream& os, const CsvDate& date)
@@ -1,23 +1,45 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string_view>
 #include <string>
 
 namespace hokee
 {
+/// Date packed into one integer yyyymmdd, so that comparisons are single integer compares
 class CsvDate
 {
-    int _year{-1};
-    int _month{-1};
-    int _day{-1};
-    std::string _dateStr{};
-    std::string _formatStr="dd.mm.yyyy";
+    enum Format : uint8_t
+    {
+        DD_MM_YY_DOTS,
+        DD_MM_YYYY_DOTS,
+        YYYY_MM_DD_DASHES,
+        MM_DD_YYYY_SLASHES,
+        DD_MM_YYYY_SLASHES,
+        YYYYMMDD,
+        FORMAT_COUNT
+    };
+
+    /// yyyymmdd, 0 for an empty date
+    int32_t _date{0};
+    Format _format{DD_MM_YYYY_DOTS};
+
+    CsvDate(int32_t date, Format format);
+
+    template <Format F>
+    static CsvDate Parse(std::string_view dateStr);
+
+    static bool FindFormat(std::string_view formatStr, Format& format);
 
   public:
+    /// Parses date strings of one format, see GetParser()
+    typedef CsvDate (*Parser)(std::string_view dateStr);
+
     CsvDate() = default;
 
-    /// Valid format strings: "dd.mm.yy", "dd.mm.yyyy"
+    /// Valid format strings: "dd.mm.yy", "dd.mm.yyyy", "yyyy-mm-dd", "mm/dd/yyyy", "dd/mm/yyyy", "yyyymmdd"
+    /// Prefer GetParser() to parse many dates of the same format.
     CsvDate(std::string_view formatStr, std::string_view dateStr);
     ~CsvDate() = default;
 
@@ -26,31 +48,54 @@ class CsvDate
     CsvDate(CsvDate&&) = default;
     CsvDate& operator=(CsvDate&&) = default;
 
-    bool operator==(const CsvDate& rhs) const;
-    bool operator!=(const CsvDate& rhs) const;
-    bool operator<(const CsvDate& other) const;
+    inline bool operator==(const CsvDate& rhs) const
+    {
+        return _date == rhs._date;
+    }
 
-    inline int GetMonth()
+    inline bool operator!=(const CsvDate& rhs) const
     {
-        return _month;
+        return _date != rhs._date;
     }
 
-    inline int GetYear()
+    inline bool operator<(const CsvDate& other) const
     {
-        return _year;
+        return _date < other._date;
     }
 
-    inline int GetDay()
+    inline bool IsEmpty() const
     {
-        return _day;
+        return _date == 0;
     }
 
-    inline const std::string& GetFormat()
+    /// yyyymmdd, 0 for an empty date
+    inline int32_t ToInt() const
     {
-        return _formatStr;
+        return _date;
     }
 
-    const std::string& ToString() const;
+    inline int GetMonth() const
+    {
+        return IsEmpty() ? -1 : _date / 100 % 100;
+    }
+
+    inline int GetYear() const
+    {
+        return IsEmpty() ? -1 : _date / 10000;
+    }
+
+    inline int GetDay() const
+    {
+        return IsEmpty() ? -1 : _date % 100;
+    }
+
+    std::string GetFormat() const;
+
+    /// Resolves a format string to its parser, throws UserException for unsupported format strings
+    static Parser GetParser(std::string_view formatStr);
+
+    /// Formats "dd.mm.yyyy", "" for an empty date
+    std::string ToString() const;
 
     friend std::ostream& operator<<(std::ostream& os, const CsvDate& date);
 };
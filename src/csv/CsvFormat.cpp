@@ -1,4 +1,5 @@
 #include "CsvFormat.h"
+#include "UserException.h"
 
 #include <fmt/format.h>
 
@@ -37,6 +38,19 @@ void CsvFormat::InitializeProperties(const fs::path& file)
     _date = GetInt("Date");
     _account = GetInt("Account");
     _value = GetInt("Value");
+
+    _dateParser = nullptr;
+    if (_date >= 0)
+    {
+        try
+        {
+            _dateParser = CsvDate::GetParser(_dateFormat);
+        }
+        catch (const UserException& e)
+        {
+            throw UserException(e.what(), file);
+        }
+    }
 }
 
 const std::string CsvFormat::GetFormatName() const
@@ -44,12 +58,12 @@ const std::string CsvFormat::GetFormatName() const
     return _formatName;
 }
 
-const std::string CsvFormat::GetAccountOwner() const
+const std::string& CsvFormat::GetAccountOwner() const
 {
     return _accountOwner;
 }
 
-const std::vector<std::string> CsvFormat::GetColumnNames() const
+const std::vector<std::string>& CsvFormat::GetColumnNames() const
 {
     return _columnNames;
 }
@@ -74,11 +88,16 @@ char CsvFormat::GetDelimiter() const
     return _delimiter;
 }
 
-const std::string CsvFormat::GetDateFormat() const
+const std::string& CsvFormat::GetDateFormat() const
 {
     return _dateFormat;
 }
 
+CsvDate::Parser CsvFormat::GetDateParser() const
+{
+    return _dateParser;
+}
+
 int CsvFormat::GetIgnoreLines() const
 {
     return _ignoreLines;
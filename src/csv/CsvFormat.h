@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CsvConfig.h"
+#include "CsvDate.h"
 #include <vector>
 
 namespace hokee
@@ -15,6 +16,7 @@ class CsvFormat final : public CsvConfig
     bool _hasTrailingDelimiter;
     char _delimiter;
     std::string _dateFormat;
+    CsvDate::Parser _dateParser;
     int _ignoreLines;
     int _category;
     int _payerPayee;
@@ -42,10 +44,10 @@ class CsvFormat final : public CsvConfig
     const std::string GetFormatName() const;
 
     /// Name of the account owner
-    const std::string GetAccountOwner() const;
+    const std::string& GetAccountOwner() const;
 
     /// CSV header
-    const std::vector<std::string> GetColumnNames() const;
+    const std::vector<std::string>& GetColumnNames() const;
 
     /// If true, parser checks that header in the csv file matches the ColumnNames property
     bool GetHasHeader() const;
@@ -63,7 +65,10 @@ class CsvFormat final : public CsvConfig
     char GetDelimiter() const;
 
     /// Format of date string in the csv file
-    const std::string GetDateFormat() const;
+    const std::string& GetDateFormat() const;
+
+    /// Parser of the date format, resolved once. (nullptr, if there is no date column)
+    CsvDate::Parser GetDateParser() const;
 
     // Column of Category string. (Set to -1, if it is not supported in the csv file)
     int GetCategory() const;
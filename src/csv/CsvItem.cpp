@@ -1,53 +1,33 @@
 #include "CsvItem.h"
 #include <fmt/format.h>
-#include <regex>
 #include <sstream>
 
 namespace hokee
 {
-void CsvItem::ToLower()
+CsvItem::CsvItem()
+    : _columns{std::make_shared<CsvColumns>()}
+    , _row{_columns->AddRow()}
 {
-        this->Account = Utils::ToLower(this->Account);
-        this->Category = Utils::ToLower(this->Category);
-        this->Description = Utils::ToLower(this->Description);
-        this->Payer = Utils::ToLower(this->Payer);
-        this->Payee = Utils::ToLower(this->Payee);
-        this->PayerPayee = Utils::ToLower(this->PayerPayee);
-        this->Type = Utils::ToLower(this->Type);
 }
 
-void CsvItem::UpdateRegex()
+CsvItem::CsvItem(std::shared_ptr<CsvColumns> columns, size_t row)
+    : _columns{std::move(columns)}
+    , _row{row}
 {
-        this->AccountRegex = std::regex(this->Account);
-        this->DescriptionRegex = std::regex(this->Description);
-        this->PayerPayeeRegex = std::regex(this->PayerPayee);
-        this->TypeRegex = std::regex(this->Type);
 }
 
-std::string CsvItem::ToString()
+void CsvItem::ToLower()
 {
-    std::stringstream result;
-
-    result << Category << " | " << PayerPayee << " | " << Description << " | " << Type << " | " << Date << " | "
-           << Value;
-    return result.str();
+    _columns->ToLower(_row);
 }
 
-void CsvItem::Match(const std::shared_ptr<CsvItem>& rule)
+std::string CsvItem::ToString() const
 {
-    bool match = true;
-    match = match && (rule->PayerPayee.empty() || std::regex_search(PayerPayee, rule->PayerPayeeRegex));
-    match = match && (rule->Description.empty() || std::regex_search(Description, rule->DescriptionRegex));
-    match = match && (rule->Date.GetYear() < 0 || Date.ToString() == rule->Date.ToString());
-    match = match && (rule->Type.empty() || std::regex_search(Type, rule->TypeRegex));
-    match = match && (rule->Account.empty() || std::regex_search(Account, rule->AccountRegex));
-    match = match && (rule->Value.ToString().empty() || Value.ToString() == rule->Value.ToString());
+    std::stringstream result;
 
-    if (match)
-    {
-        this->References.push_back(rule.get());
-        rule->References.push_back(this);
-        this->Category = rule->Category;
-    }
+    result << GetCategory() << " | " << GetPayerPayee() << " | " << GetDescription() << " | " << GetType() << " | "
+           << GetDate() << " | " << GetValue();
+    return result.str();
 }
-} // namespace hokee
\ No newline at end of file
+
+} // namespace hokee
@@ -1,50 +1,152 @@
 #pragma once
 
 #include "../Utils.h"
+#include "CsvColumns.h"
 #include "CsvDate.h"
+#include "CsvSymbol.h"
 #include "CsvValue.h"
 
 #include <memory>
-#include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace hokee
 {
 
-struct CsvItem
+/// Row of a CsvTable. The fields are stored in the CsvColumns of the table (see CsvTable::AddItem()), the item
+/// only keeps the row, its id, references and issues. Items without table store their fields in own columns.
+class CsvItem
 {
-    CsvDate Date = {};
-    std::string Type = {};
-    std::string PayerPayee = {};
-    std::string Payer = {};
-    std::string Payee = {};
-    std::string Account = {};
-    std::string Description = {};
-    CsvValue Value = {};
-    std::string Category = {};
+    friend class CsvTable;
+
+    std::shared_ptr<CsvColumns> _columns;
+    size_t _row;
+
+  public:
     std::vector<std::string> Issues = {};
     std::vector<CsvItem*> References = {};
-    fs::path File = {};
-    int Line = -1;
     int Id = -1;
-    std::regex AccountRegex = {};
-    std::regex DescriptionRegex = {};
-    std::regex PayerPayeeRegex = {};
-    std::regex TypeRegex = {};
+
+    CsvItem();
+    CsvItem(std::shared_ptr<CsvColumns> columns, size_t row);
+    ~CsvItem() = default;
+
+    CsvItem(const CsvItem&) = delete;
+    CsvItem& operator=(const CsvItem&) = delete;
+    CsvItem(CsvItem&&) = delete;
+    CsvItem& operator=(CsvItem&&) = delete;
+
+    inline const CsvColumns& GetColumns() const
+    {
+        return *_columns;
+    }
+
+    inline size_t GetRow() const
+    {
+        return _row;
+    }
+
+    inline const CsvDate& GetDate() const
+    {
+        return _columns->GetDate(_row);
+    }
+
+    inline CsvSymbol GetType() const
+    {
+        return _columns->GetType(_row);
+    }
+
+    inline std::string_view GetPayerPayee() const
+    {
+        return _columns->GetPayerPayee(_row);
+    }
+
+    inline CsvSymbol GetAccount() const
+    {
+        return _columns->GetAccount(_row);
+    }
+
+    inline std::string_view GetDescription() const
+    {
+        return _columns->GetDescription(_row);
+    }
+
+    inline const CsvValue& GetValue() const
+    {
+        return _columns->GetValue(_row);
+    }
+
+    inline CsvSymbol GetCategory() const
+    {
+        return _columns->GetCategory(_row);
+    }
+
+    inline CsvSymbol GetFile() const
+    {
+        return _columns->GetFile(_row);
+    }
+
+    inline int GetLine() const
+    {
+        return _columns->GetLine(_row);
+    }
+
+    inline void SetDate(const CsvDate& date)
+    {
+        _columns->SetDate(_row, date);
+    }
+
+    inline void SetType(CsvSymbol type)
+    {
+        _columns->SetType(_row, type);
+    }
+
+    inline void SetPayerPayee(std::string_view payerPayee)
+    {
+        _columns->SetPayerPayee(_row, payerPayee);
+    }
+
+    inline void SetAccount(CsvSymbol account)
+    {
+        _columns->SetAccount(_row, account);
+    }
+
+    inline void SetDescription(std::string_view description)
+    {
+        _columns->SetDescription(_row, description);
+    }
+
+    inline void SetValue(const CsvValue& value)
+    {
+        _columns->SetValue(_row, value);
+    }
+
+    inline void SetCategory(CsvSymbol category)
+    {
+        _columns->SetCategory(_row, category);
+    }
+
+    inline void SetFile(CsvSymbol file)
+    {
+        _columns->SetFile(_row, file);
+    }
+
+    inline void SetLine(int line)
+    {
+        _columns->SetLine(_row, line);
+    }
 
     bool operator==(const CsvItem& ref) const
     {
-        return Date.ToString() == ref.Date.ToString() && Type == ref.Type && PayerPayee == ref.PayerPayee
-               && Account == ref.Account && Description == ref.Description
-               && Value.ToString() == ref.Value.ToString();
+        return GetDate() == ref.GetDate() && GetType() == ref.GetType() && GetPayerPayee() == ref.GetPayerPayee()
+               && GetAccount() == ref.GetAccount() && GetDescription() == ref.GetDescription()
+               && GetValue() == ref.GetValue();
     }
-    void Match(const std::shared_ptr<CsvItem>& rule);
 
-    std::string ToString();
-    void UpdateRegex();
+    std::string ToString() const;
     void ToLower();
 };
 
 typedef std::shared_ptr<CsvItem> CsvRowShared;
-} // namespace hokee
\ No newline at end of file
+} // namespace hokee
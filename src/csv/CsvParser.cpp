@@ -1,201 +1,372 @@
 #include "CsvParser.h"
 #include "InternalException.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 #include "CsvValue.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include <exception>
+#include <iterator>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <string_view>
 
 namespace hokee
 {
-CsvParser::CsvParser(const fs::path& file, const CsvFormat& format)
-    : _file{file}
-    , _ifstream{file}
+CsvParser::CsvParser(const fs::path& file, const CsvFormat& format, ThreadPool& threadPool)
+    : _threadPool{threadPool}
+    , _file{file}
+    , _fileName{file.string()}
+    , _input{std::make_shared<MappedFile>(file)}
+    , _end{_input->GetSize()}
     , _format{format}
+    , _scanner{format.GetDelimiter()}
 {
-    if (_ifstream.fail())
+    if (_format.GetAccount() < 0)
     {
-        throw InternalException(__FILE__, __LINE__, fmt::format("Could not open file {}", file.string()));
+        _accountName = fmt::format("{} ({})", _format.GetFormatName(), _format.GetAccountOwner());
     }
 }
 
-void CsvParser::Load(CsvTable& csvData)
+CsvParser::CsvParser(const CsvParser& parser, size_t begin, size_t end, int lineCounter)
+    : _threadPool{parser._threadPool}
+    , _lineCounter{lineCounter}
+    , _file{parser._file}
+    , _fileName{parser._fileName}
+    , _input{parser._input}
+    , _position{begin}
+    , _end{end}
+    , _format{parser._format}
+    , _accountName{parser._accountName}
+    , _scanner{parser._scanner}
+    , _scanned{begin}
+{
+}
+
+void CsvParser::Load(CsvTable& csvData, size_t threadCount, size_t minChunkSize)
 {
-    std::string line;
+    char* begin = nullptr;
+    char* end = nullptr;
     std::vector<std::string> header{};
     while (_lineCounter < _format.GetIgnoreLines())
     {
         _lineCounter++;
-        std::getline(_ifstream, line);
-        header.push_back(line);
+        if (GetLine(begin, end))
+        {
+            header.emplace_back(begin, end);
+        }
+        else
+        {
+            header.emplace_back();
+        }
     }
     csvData.SetCsvHeader(std::move(header));
+    _scanned = _position;
 
-    auto item = std::make_shared<CsvItem>();
-    while (ParseItem(item))
+    if (threadCount == 0)
+    {
+        threadCount = _threadPool.GetThreadCount();
+    }
+    const size_t chunkCount = std::min(threadCount, (_end - _position) / std::max<size_t>(minChunkSize, 1));
+    if (chunkCount > 1)
     {
-        csvData.push_back(item);
-        item = std::make_shared<CsvItem>();
+        LoadChunks(csvData, chunkCount);
+    }
+    else
+    {
+        LoadItems(csvData);
     }
 }
 
-void CsvParser::AssignValue(std::string& value, std::vector<std::string> cells, size_t id)
+void CsvParser::LoadItems(CsvTable& csvData)
+{
+    while (ParseItem(csvData))
+    {
+    }
+}
+
+void CsvParser::LoadChunks(CsvTable& csvData, size_t chunkCount)
+{
+    // Split the remaining buffer into chunks that end after a '\n'
+    const char* data = _input->GetData();
+    std::vector<size_t> bounds{_position};
+    for (size_t c = 1; c < chunkCount; ++c)
+    {
+        const size_t bound = std::max(bounds.back(), _position + (_end - _position) * c / chunkCount);
+        const void* newline = std::memchr(data + bound, '\n', _end - bound);
+        if (newline == nullptr || static_cast<const char*>(newline) + 1 == data + _end)
+        {
+            break;
+        }
+        bounds.push_back(static_cast<size_t>(static_cast<const char*>(newline) - data) + 1);
+    }
+    bounds.push_back(_end);
+    chunkCount = bounds.size() - 1;
+
+    // Count lines per chunk to know the line number each chunk starts with
+    std::vector<size_t> lineCounts(chunkCount);
+    auto countLinesCallback = [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            lineCounts[c] = static_cast<size_t>(std::count(data + bounds[c], data + bounds[c + 1], '\n'));
+        }
+    };
+    _threadPool.ParallelFor("", chunkCount, countLinesCallback, 1);
+
+    std::vector<std::unique_ptr<CsvParser>> parsers;
+    int lineCounter = _lineCounter;
+    for (size_t c = 0; c < chunkCount; ++c)
+    {
+        parsers.emplace_back(new CsvParser(*this, bounds[c], bounds[c + 1], lineCounter));
+        lineCounter += static_cast<int>(lineCounts[c]);
+    }
+
+    // Parse chunks. Errors are reported for the first failing chunk, i.e. the first invalid line.
+    std::vector<CsvTable> tables(chunkCount);
+    std::vector<std::exception_ptr> errors(chunkCount);
+    auto parseChunksCallback = [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            try
+            {
+                parsers[c]->LoadItems(tables[c]);
+            }
+            catch (...)
+            {
+                errors[c] = std::current_exception();
+            }
+        }
+    };
+    const std::string phase = fmt::format("Parse '{}'", _file.filename().string());
+    _threadPool.ParallelFor(phase, chunkCount, parseChunksCallback, 1);
+    for (auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (auto& table : tables)
+    {
+        csvData.Append(std::move(table));
+    }
+}
+
+void CsvParser::AssignValue(std::string_view& value, size_t id)
 {
     if (id == static_cast<size_t>(~0))
     {
         return;
     }
 
-    if (id >= cells.size())
+    if (id >= _cells.size())
     {
         throw UserException(fmt::format("Could not parse file. There is no column {}", id), _file, _lineCounter);
     }
-    value = cells[id];
+    value = _cells[id];
 }
 
-bool CsvParser::GetItem(CsvRowShared& item)
+bool CsvParser::GetLine(char*& begin, char*& end)
 {
-    std::string line;
-    while (std::getline(_ifstream, line))
+    if (_position >= _end)
     {
-        ++_lineCounter;
+        return false;
+    }
 
-        if (line.empty())
+    begin = _input->GetData() + _position;
+    char* last = _input->GetData() + _end;
+    end = static_cast<char*>(std::memchr(begin, '\n', static_cast<size_t>(last - begin)));
+    if (end == nullptr)
+    {
+        end = last;
+    }
+    _position = static_cast<size_t>(end - _input->GetData()) + 1;
+    return true;
+}
+
+bool CsvParser::GetCells(std::string_view& line)
+{
+    if (_position >= _end)
+    {
+        return false;
+    }
+
+    char* data = _input->GetData();
+    const size_t lineBegin = _position;
+    size_t lineEnd = _end;
+    size_t cellBegin = lineBegin;
+    _cells.clear();
+    while (true)
+    {
+        if (_nextStructural == _structurals.size())
         {
+            if (_scanned >= _end)
+            {
+                break;
+            }
+            // Scan next window of the buffer (replaces nonprintable characters in place)
+            const size_t windowEnd = std::min(_scanned + SCAN_WINDOW_SIZE, _end);
+            _structurals.clear();
+            _nextStructural = 0;
+            _scanner.Scan(data, _scanned, windowEnd, _structurals);
+            _scanned = windowEnd;
             continue;
         }
 
-        // replace nonprintable characters
-        for (auto& c : line)
+        const size_t position = _structurals[_nextStructural++];
+        if (data[position] == '\n')
         {
-            if (c == '\n' || c == '\r' || c == '\0')
-            {
-                continue;
-            }
-            if (c == '\t')
-            {
-                c = '_';
-            }
-            const auto uc = static_cast<unsigned char>(c);
-            if (uc < 32 || uc > 126)
-            {
-                c = '_';
-            }
+            lineEnd = position;
+            break;
         }
+        _cells.emplace_back(data + cellBegin, position - cellBegin);
+        cellBegin = position + 1;
+    }
+    _position = lineEnd + 1;
+    line = std::string_view(data + lineBegin, lineEnd - lineBegin);
 
-        std::vector<std::string> cells
-            = Utils::SplitLine(line, _format.GetDelimiter(), _format.GetHasTrailingDelimiter());
-        if (_format.GetColumnNames().size() != cells.size())
+    // A trailing delimiter only adds an empty cell if !HasTrailingDelimiter
+    if (cellBegin < lineEnd || (cellBegin > lineBegin && !_format.GetHasTrailingDelimiter()))
+    {
+        _cells.emplace_back(data + cellBegin, lineEnd - cellBegin);
+    }
+    return true;
+}
+
+bool CsvParser::GetItem(CsvTable& csvData, std::string_view& payer, std::string_view& payee)
+{
+    std::string_view line{};
+    while (GetCells(line))
+    {
+        ++_lineCounter;
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (_format.GetColumnNames().size() != _cells.size())
         {
             throw UserException(
                 fmt::format("Could not parse file. Line does not match expected column count ({} != {})",
-                            _format.GetColumnNames().size(), cells.size()),
+                            _format.GetColumnNames().size(), _cells.size()),
                 _file, _lineCounter);
         }
 
-        std::vector<std::string> trimmedCells = {};
-        for (auto& cell : cells)
+        for (auto& cell : _cells)
         {
-            if (cell.size() == 0)
+            if (cell.size() == 0 || !_format.GetHasDoubleQuotes())
             {
-                trimmedCells.push_back("");
                 continue;
             }
-            if (!_format.GetHasDoubleQuotes())
+            if (cell.size() < 2)
             {
-                trimmedCells.push_back(cell);
+                throw UserException(fmt::format("Could not parse file. Cells with double quotes "
+                                                "formats must be empty or must have 2 char, at least."),
+                                    _file.string(), _lineCounter);
             }
-            else
+            if (cell[0] != '"')
             {
-                if (cell.size() < 2)
-                {
-                    throw UserException(fmt::format("Could not parse file. Cells with double quotes "
-                                                    "formats must be empty or must have 2 char, at least."),
-                                        _file.string(), _lineCounter);
-                }
-                if (cell[0] != '"')
-                {
-                    throw UserException(
-                        fmt::format("Could not parse file. Cell '{}' does not start with double quotes '\"'",
-                                    cell),
-                        _file, _lineCounter);
-                }
-                if (cell[cell.size() - 1] != '"')
-                {
-                    throw UserException(
-                        fmt::format("Could not parse file. Cell '{}' does not end with double quotes '\"'", cell),
-                        _file, _lineCounter);
-                }
-
-                trimmedCells.push_back(cell.substr(1, cell.size() - 2));
+                throw UserException(
+                    fmt::format("Could not parse file. Cell '{}' does not start with double quotes '\"'", cell),
+                    _file, _lineCounter);
             }
+            if (cell[cell.size() - 1] != '"')
+            {
+                throw UserException(
+                    fmt::format("Could not parse file. Cell '{}' does not end with double quotes '\"'", cell),
+                    _file, _lineCounter);
+            }
+
+            cell = cell.substr(1, cell.size() - 2);
         }
 
         // Check header
         if (_format.GetHasHeader() && _lineCounter == _format.GetIgnoreLines() + 1)
         {
-            auto columnNames = _format.GetColumnNames();
-            for (size_t i = 0; i < trimmedCells.size(); ++i)
+            const auto& columnNames = _format.GetColumnNames();
+            for (size_t i = 0; i < _cells.size(); ++i)
             {
-                if (trimmedCells[i] != columnNames[i])
+                if (_cells[i] != columnNames[i])
                 {
                     throw UserException(
                         fmt::format("Could not parse file. Header column {} does not match expected column {}",
-                                    trimmedCells[i], columnNames[i]),
+                                    _cells[i], columnNames[i]),
                         _file, _lineCounter);
                 }
             }
             continue;
         }
 
-        AssignValue(item->Account, trimmedCells, _format.GetAccount());
-        std::string value;
-        AssignValue(value, trimmedCells, _format.GetValue());
-        item->Value = CsvValue(value, _file.string(), _lineCounter);
-        
-        AssignValue(item->Category, trimmedCells, _format.GetCategory());
-        AssignValue(item->Description, trimmedCells, _format.GetDescription());
-        AssignValue(item->Type, trimmedCells, _format.GetType());
-        AssignValue(item->Payer, trimmedCells, _format.GetPayer());
-        AssignValue(item->Payee, trimmedCells, _format.GetPayee());
-        AssignValue(item->PayerPayee, trimmedCells, _format.GetPayerPayee());
-        item->Line = _lineCounter;
+        std::string_view account{};
+        AssignValue(account, _format.GetAccount());
+        std::string_view value{};
+        AssignValue(value, _format.GetValue());
+        const CsvValue csvValue(value, _file, _lineCounter);
 
-        std::string dateStr;
-        AssignValue(dateStr, trimmedCells, _format.GetDate());
+        std::string_view category{};
+        std::string_view description{};
+        std::string_view type{};
+        std::string_view payerPayee{};
+        AssignValue(category, _format.GetCategory());
+        AssignValue(description, _format.GetDescription());
+        AssignValue(type, _format.GetType());
+        AssignValue(payer, _format.GetPayer());
+        AssignValue(payee, _format.GetPayee());
+        AssignValue(payerPayee, _format.GetPayerPayee());
 
-        try
+        std::string_view dateStr{};
+        AssignValue(dateStr, _format.GetDate());
+        CsvDate date{};
+        if (!dateStr.empty())
         {
-            item->Date = CsvDate(_format.GetDateFormat(), dateStr);
-        }
-        catch (const std::exception& e)
-        {
-            throw UserException(e.what(), _file, _lineCounter);
+            try
+            {
+                date = _format.GetDateParser()(dateStr);
+            }
+            catch (const std::exception& e)
+            {
+                throw UserException(e.what(), _file, _lineCounter);
+            }
         }
+
+        const CsvRowShared& item = csvData.AddItem();
+        item->SetAccount(account);
+        item->SetValue(csvValue);
+        item->SetCategory(category);
+        item->SetDescription(description);
+        item->SetType(type);
+        item->SetPayerPayee(payerPayee);
+        item->SetLine(_lineCounter);
+        item->SetDate(date);
         return true;
     }
 
     return false;
 }
 
-bool CsvParser::ParseItem(CsvRowShared& item)
+bool CsvParser::ParseItem(CsvTable& csvData)
 {
-    const bool result = GetItem(item);
+    std::string_view payer{};
+    std::string_view payee{};
+    const bool result = GetItem(csvData, payer, payee);
     if (!result)
     {
         return false;
     }
+    const CsvRowShared& item = csvData.back();
 
     // Set Account name
     if (_format.GetAccount() < 0)
     {
-        item->Account = fmt::format("{} ({})", _format.GetFormatName(), _format.GetAccountOwner());
+        item->SetAccount(_accountName);
     }
 
     // The csv file may contain separate Payer and Payee columns, or a single
@@ -206,24 +377,24 @@ bool CsvParser::ParseItem(CsvRowShared& item)
         if (_format.GetPayer() < 0 && _format.GetPayee() >= 0)
         {
             // Assign Payee
-            item->PayerPayee = item->Payee;
+            item->SetPayerPayee(payee);
         }
         else if (_format.GetPayer() >= 0 && _format.GetPayee() < 0)
         {
             // Assign Payer
-            item->PayerPayee = item->Payer;
+            item->SetPayerPayee(payer);
         }
         else if (_format.GetPayer() >= 0 && _format.GetPayee() >= 0)
         {
             // Merge Payer/Payee by not selecting the owner
             // (Assumption: Payer or Payee equals AccountOwner)
-            if (item->Payer == _format.GetAccountOwner())
+            if (payer == _format.GetAccountOwner())
             {
-                item->PayerPayee = item->Payee;
+                item->SetPayerPayee(payee);
             }
             else
             {
-                item->PayerPayee = item->Payer;
+                item->SetPayerPayee(payer);
             }
         }
     }
@@ -239,8 +410,7 @@ bool CsvParser::ParseItem(CsvRowShared& item)
     }
 
     // Set further parameter
-    item->Id = Utils::GenerateId();
-    item->File = _file;
+    item->SetFile(_fileName);
 
     return result;
 }
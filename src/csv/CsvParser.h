@@ -2,29 +2,55 @@
 
 #include "csv/CsvTable.h"
 #include "csv/CsvFormat.h"
+#include "csv/CsvScanner.h"
+#include "csv/CsvSymbol.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 
-#include <fstream>
 #include <memory>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace hokee
 {
 
 class CsvParser
 {
+    static constexpr size_t SCAN_WINDOW_SIZE = 64 * 1024;
+    static constexpr size_t MIN_CHUNK_SIZE = 16 * 1024 * 1024;
+
+    ThreadPool& _threadPool;
     int _lineCounter = 0;
     fs::path _file = {};
-    std::ifstream _ifstream = {};
+    CsvSymbol _fileName{};
+    std::shared_ptr<MappedFile> _input;
+    size_t _position = 0;
+    size_t _end = 0;
     CsvFormat _format;
+    CsvSymbol _accountName{};
+    CsvScanner _scanner;
+    std::vector<size_t> _structurals = {};
+    size_t _nextStructural = 0;
+    size_t _scanned = 0;
+    std::vector<std::string_view> _cells = {};
+
+    void AssignValue(std::string_view& value, size_t id);
 
-    void AssignValue(std::string& value, std::vector<std::string> cells, size_t id);
+    bool GetLine(char*& begin, char*& end);
+    bool GetCells(std::string_view& line);
+    bool GetItem(CsvTable& csvData, std::string_view& payer, std::string_view& payee);
+    bool ParseItem(CsvTable& csvData);
+    void LoadItems(CsvTable& csvData);
+    void LoadChunks(CsvTable& csvData, size_t chunkCount);
 
-    bool GetItem(CsvRowShared& item);
-    bool ParseItem(CsvRowShared& item);
+    /// Parser for the lines in [begin, end) of the same file. lineCounter is the number of lines before begin.
+    CsvParser(const CsvParser& parser, size_t begin, size_t end, int lineCounter);
 
   public:
-    CsvParser(const fs::path& file, const CsvFormat& format);
+    /// Large files are parsed in chunks on the threadPool
+    CsvParser(const fs::path& file, const CsvFormat& format, ThreadPool& threadPool = ThreadPool::GetInstance());
     ~CsvParser() = default;
 
     CsvParser(const CsvParser&) = delete;
@@ -32,7 +58,9 @@ class CsvParser
     CsvParser(CsvParser&&) = delete;
     CsvParser& operator=(CsvParser&&) = delete;
 
-    void Load(CsvTable& csvData);
+    /// Files larger than 2 * minChunkSize are split into up to threadCount (0: thread pool size) newline aligned
+    /// chunks, which are parsed in parallel. Rows and line numbers equal those of sequential parsing.
+    void Load(CsvTable& csvData, size_t threadCount = 0, size_t minChunkSize = MIN_CHUNK_SIZE);
 };
 
 } // namespace hokee
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "CsvPattern.h"
+
+#include <cstring>
+
+namespace hokee
+{
+namespace
+{
+// Characters with a special meaning in ECMAScript regular expressions
+constexpr const char* SPECIAL_CHARS = "\\^$.|?*+()[]{}";
+} // namespace
+
+CsvPattern::CsvPattern(const std::string& pattern)
+    : _pattern{pattern}
+{
+    const bool begins = !pattern.empty() && pattern.front() == '^';
+    const bool ends = pattern.size() > static_cast<size_t>(begins) && pattern.back() == '$'
+                      && (pattern.size() < 2 || pattern[pattern.size() - 2] != '\\');
+    if (ParseLiteral(pattern, begins ? 1 : 0, ends ? pattern.size() - 1 : pattern.size(), _literal))
+    {
+        _kind = begins ? (ends ? Kind::Exact : Kind::Prefix) : (ends ? Kind::Suffix : Kind::Literal);
+        _requiredLiteral = _literal;
+    }
+    else
+    {
+        _kind = Kind::Regex;
+        _literal.clear();
+        _regex = std::make_unique<std::regex>(pattern);
+        _requiredLiteral = ExtractRequiredLiteral(pattern);
+    }
+}
+
+std::string CsvPattern::ExtractRequiredLiteral(const std::string& pattern)
+{
+    // Conservative: returns the longest run of literal characters which is neither optional nor part of an
+    // alternation, group or character class. Returns an empty string for anything not understood.
+    std::string longest{};
+    std::string current{};
+    auto endRun = [&]() {
+        if (current.size() > longest.size())
+        {
+            longest = current;
+        }
+        current.clear();
+    };
+    auto skipClass = [&](size_t& i) {
+        for (++i; i < pattern.size() && pattern[i] != ']'; ++i)
+        {
+            i += pattern[i] == '\\' ? 1 : 0;
+        }
+        return i < pattern.size();
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        const char c = pattern[i];
+        switch (c)
+        {
+        case '\\':
+            if (i + 1 < pattern.size() && pattern[i + 1] != '\0' && std::strchr(SPECIAL_CHARS, pattern[i + 1]))
+            {
+                current += pattern[++i];
+            }
+            else if (i + 1 < pattern.size() && pattern[i + 1] != '\0' && std::strchr("dDwWsSbB", pattern[i + 1]))
+            {
+                endRun();
+                ++i;
+            }
+            else
+            {
+                return {};
+            }
+            break;
+        case '|':
+        case ')':
+        case ']':
+        case '}':
+            return {};
+        case '(':
+        {
+            endRun();
+            size_t depth = 0;
+            for (; i < pattern.size(); ++i)
+            {
+                if (pattern[i] == '\\')
+                {
+                    ++i;
+                }
+                else if (pattern[i] == '[')
+                {
+                    if (!skipClass(i))
+                    {
+                        return {};
+                    }
+                }
+                else if (pattern[i] == '(')
+                {
+                    ++depth;
+                }
+                else if (pattern[i] == ')' && --depth == 0)
+                {
+                    break;
+                }
+            }
+            if (i >= pattern.size())
+            {
+                return {};
+            }
+            break;
+        }
+        case '[':
+            endRun();
+            if (!skipClass(i))
+            {
+                return {};
+            }
+            break;
+        case '?':
+        case '*':
+        case '+':
+        case '{':
+        {
+            // The previous character stays required only for "+" and "+?", any other (or a stacked)
+            // quantifier makes it optional
+            size_t end = i;
+            for (; end < pattern.size() && std::strchr("?*+{", pattern[end]) && pattern[end] != '\0'; ++end)
+            {
+                if (pattern[end] == '{')
+                {
+                    end = pattern.find('}', end);
+                    if (end == std::string::npos)
+                    {
+                        return {};
+                    }
+                }
+            }
+            const std::string quantifier = pattern.substr(i, end - i);
+            if (!current.empty() && quantifier != "+" && quantifier != "+?")
+            {
+                current.pop_back();
+            }
+            endRun();
+            i = end - 1;
+            break;
+        }
+        case '.':
+        case '^':
+        case '$':
+            endRun();
+            break;
+        default:
+            current += c;
+            break;
+        }
+    }
+    endRun();
+    return longest;
+}
+
+bool CsvPattern::ParseLiteral(const std::string& pattern, size_t begin, size_t end, std::string& literal)
+{
+    literal.clear();
+    for (size_t i = begin; i < end; ++i)
+    {
+        const char c = pattern[i];
+        if (c == '\\')
+        {
+            // Only escaped special characters are literals, e.g. "\." but not "\d" or "\b"
+            if (i + 1 >= end || std::strchr(SPECIAL_CHARS, pattern[i + 1]) == nullptr || pattern[i + 1] == '\0')
+            {
+                return false;
+            }
+            literal += pattern[++i];
+        }
+        else if (std::strchr(SPECIAL_CHARS, c) != nullptr || c == '\0')
+        {
+            return false;
+        }
+        else
+        {
+            literal += c;
+        }
+    }
+    return true;
+}
+
+bool CsvPattern::Search(std::string_view text) const
+{
+    switch (_kind)
+    {
+    case Kind::Literal:
+        return text.find(_literal) != std::string_view::npos;
+    case Kind::Prefix:
+        return text.compare(0, _literal.size(), _literal) == 0;
+    case Kind::Suffix:
+        return text.size() >= _literal.size()
+               && text.compare(text.size() - _literal.size(), _literal.size(), _literal) == 0;
+    case Kind::Exact:
+        return text == _literal;
+    default:
+        return std::regex_search(text.begin(), text.end(), *_regex);
+    }
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+
+namespace hokee
+{
+/// Compiled search pattern of a rule. Patterns without regex features are searched as plain strings.
+class CsvPattern
+{
+  public:
+    enum class Kind
+    {
+        Literal, ///< "abc": substring search
+        Prefix,  ///< "^abc": text starts with literal
+        Suffix,  ///< "abc$": text ends with literal
+        Exact,   ///< "^abc$": text equals literal
+        Regex    ///< everything else: std::regex_search
+    };
+
+  private:
+    std::string _pattern;
+    Kind _kind{Kind::Regex};
+    std::string _literal{};
+    std::string _requiredLiteral{};
+    std::unique_ptr<std::regex> _regex{};
+
+    static bool ParseLiteral(const std::string& pattern, size_t begin, size_t end, std::string& literal);
+    static std::string ExtractRequiredLiteral(const std::string& pattern);
+
+  public:
+    CsvPattern() = delete;
+    explicit CsvPattern(const std::string& pattern);
+    ~CsvPattern() = default;
+
+    CsvPattern(const CsvPattern&) = delete;
+    CsvPattern& operator=(const CsvPattern&) = delete;
+    CsvPattern(CsvPattern&&) = delete;
+    CsvPattern& operator=(CsvPattern&&) = delete;
+
+    inline const std::string& GetPattern() const
+    {
+        return _pattern;
+    }
+
+    inline Kind GetKind() const
+    {
+        return _kind;
+    }
+
+    /// Unescaped literal of all kinds except Regex
+    inline const std::string& GetLiteral() const
+    {
+        return _literal;
+    }
+
+    /// Substring that every text matching the pattern contains (may be empty)
+    inline const std::string& GetRequiredLiteral() const
+    {
+        return _requiredLiteral;
+    }
+
+    /// Same result as std::regex_search(text, std::regex(pattern))
+    bool Search(std::string_view text) const;
+};
+} // namespace hokee
\ No newline at end of file
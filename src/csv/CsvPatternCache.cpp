@@ -0,0 +1,38 @@
+#include "CsvPatternCache.h"
+
+namespace hokee
+{
+std::shared_ptr<const CsvPattern> CsvPatternCache::Get(const std::string& pattern)
+{
+    auto it = _patterns.find(pattern);
+    if (it != _patterns.end())
+    {
+        return it->second;
+    }
+
+    auto compiled = std::make_shared<const CsvPattern>(pattern);
+    ++_compileCount;
+    _patterns.emplace(pattern, compiled);
+    return compiled;
+}
+
+void CsvPatternCache::Prune()
+{
+    for (auto it = _patterns.begin(); it != _patterns.end();)
+    {
+        if (it->second.use_count() == 1)
+        {
+            it = _patterns.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void CsvPatternCache::Clear()
+{
+    _patterns.clear();
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "csv/CsvPattern.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace hokee
+{
+/// Compiled patterns keyed by pattern string. Rules with equal patterns share one compiled pattern.
+/// Not thread-safe.
+class CsvPatternCache
+{
+    std::unordered_map<std::string, std::shared_ptr<const CsvPattern>> _patterns{};
+    size_t _compileCount{0};
+
+  public:
+    CsvPatternCache() = default;
+    ~CsvPatternCache() = default;
+
+    CsvPatternCache(const CsvPatternCache&) = delete;
+    CsvPatternCache& operator=(const CsvPatternCache&) = delete;
+    CsvPatternCache(CsvPatternCache&&) = delete;
+    CsvPatternCache& operator=(CsvPatternCache&&) = delete;
+
+    /// Returns the compiled pattern, compiles it only if it is not cached yet
+    std::shared_ptr<const CsvPattern> Get(const std::string& pattern);
+
+    /// Removes patterns which are not used outside the cache anymore
+    void Prune();
+    void Clear();
+
+    inline size_t GetSize() const
+    {
+        return _patterns.size();
+    }
+
+    /// Number of patterns compiled since construction
+    inline size_t GetCompileCount() const
+    {
+        return _compileCount;
+    }
+};
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "CsvRule.h"
+
+namespace hokee
+{
+CsvRule::CsvRule(CsvItem& item, CsvPatternCache& cache)
+    : _item{&item}
+    , _date{item.GetDate()}
+    , _value{item.GetValue()}
+    , _payerPayeePattern{item.GetPayerPayee().empty() ? nullptr : cache.Get(std::string(item.GetPayerPayee()))}
+    , _descriptionPattern{item.GetDescription().empty() ? nullptr : cache.Get(std::string(item.GetDescription()))}
+    , _typePattern{item.GetType().IsEmpty() ? nullptr : cache.Get(item.GetType().ToString())}
+    , _accountPattern{item.GetAccount().IsEmpty() ? nullptr : cache.Get(item.GetAccount().ToString())}
+{
+}
+
+bool CsvRule::Match(const CsvColumns& columns, size_t row) const
+{
+    // Empty fields of the rule have no pattern and match every row
+    bool match = true;
+    match = match && (!_payerPayeePattern || _payerPayeePattern->Search(columns.GetPayerPayee(row)));
+    match = match && (!_descriptionPattern || _descriptionPattern->Search(columns.GetDescription(row)));
+    match = match && (_date.IsEmpty() || columns.GetDate(row) == _date);
+    match = match && (!_typePattern || _typePattern->Search(columns.GetType(row).ToString()));
+    match = match && (!_accountPattern || _accountPattern->Search(columns.GetAccount(row).ToString()));
+    match = match && (_value.IsEmpty() || columns.GetValue(row) == _value);
+    return match;
+}
+} // namespace hokee
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "csv/CsvItem.h"
+#include "csv/CsvPattern.h"
+#include "csv/CsvPatternCache.h"
+
+#include <memory>
+
+namespace hokee
+{
+/// Compiled form of one item of CsvRules. Only rules need patterns, so data rows (CsvItem) do not carry them.
+class CsvRule
+{
+    CsvItem* _item;
+    CsvDate _date;
+    CsvValue _value;
+    std::shared_ptr<const CsvPattern> _payerPayeePattern;
+    std::shared_ptr<const CsvPattern> _descriptionPattern;
+    std::shared_ptr<const CsvPattern> _typePattern;
+    std::shared_ptr<const CsvPattern> _accountPattern;
+
+  public:
+    /// Compiles the patterns of the (lower case) rule, patterns which are already cached are shared
+    CsvRule(CsvItem& item, CsvPatternCache& cache);
+    ~CsvRule() = default;
+
+    CsvRule(const CsvRule&) = default;
+    CsvRule& operator=(const CsvRule&) = default;
+    CsvRule(CsvRule&&) = default;
+    CsvRule& operator=(CsvRule&&) = default;
+
+    /// Matches a row of the columns. Does not modify References (MatchRules collects the matches of all threads
+    /// first).
+    bool Match(const CsvColumns& columns, size_t row) const;
+
+    inline bool Match(const CsvItem& row) const
+    {
+        return Match(row.GetColumns(), row.GetRow());
+    }
+
+    inline CsvItem& GetItem() const
+    {
+        return *_item;
+    }
+
+    /// Patterns are nullptr for empty fields of the rule, which match every row
+    inline const CsvPattern* GetPayerPayeePattern() const
+    {
+        return _payerPayeePattern.get();
+    }
+
+    inline const CsvPattern* GetDescriptionPattern() const
+    {
+        return _descriptionPattern.get();
+    }
+
+    inline const CsvPattern* GetTypePattern() const
+    {
+        return _typePattern.get();
+    }
+
+    inline const CsvPattern* GetAccountPattern() const
+    {
+        return _accountPattern.get();
+    }
+};
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "CsvRuleFilter.h"
+
+#include <algorithm>
+
+namespace hokee
+{
+void CsvRuleFilter::Build(const std::vector<CsvRule>& rules)
+{
+    for (auto& automaton : _automata)
+    {
+        automaton.Clear();
+    }
+    _unfiltered.clear();
+
+    for (size_t r = 0; r < rules.size(); ++r)
+    {
+        const auto& rule = rules[r];
+        const std::array<const CsvPattern*, FieldCount> patterns{{
+            rule.GetPayerPayeePattern(),
+            rule.GetDescriptionPattern(),
+            rule.GetTypePattern(),
+            rule.GetAccountPattern(),
+        }};
+
+        // Empty fields match everything, only the other ones can provide a key
+        const std::string* key = nullptr;
+        size_t keyField = FieldCount;
+        for (size_t f = 0; f < FieldCount; ++f)
+        {
+            if (patterns[f] == nullptr)
+            {
+                continue;
+            }
+            const std::string& literal = patterns[f]->GetRequiredLiteral();
+            if (!literal.empty() && (key == nullptr || literal.size() > key->size()))
+            {
+                key = &literal;
+                keyField = f;
+            }
+        }
+
+        if (key == nullptr)
+        {
+            _unfiltered.push_back(r);
+        }
+        else
+        {
+            _automata[keyField].Add(*key, static_cast<uint32_t>(r));
+        }
+    }
+
+    for (auto& automaton : _automata)
+    {
+        automaton.Build();
+    }
+}
+
+void CsvRuleFilter::GetCandidates(const CsvColumns& columns, size_t row, std::vector<size_t>& candidates) const
+{
+    candidates.assign(_unfiltered.begin(), _unfiltered.end());
+    auto addCandidate = [&candidates](uint32_t r) { candidates.push_back(r); };
+    _automata[PayerPayeeField].Search(columns.GetPayerPayee(row), addCandidate);
+    _automata[DescriptionField].Search(columns.GetDescription(row), addCandidate);
+    _automata[TypeField].Search(columns.GetType(row).ToString(), addCandidate);
+    _automata[AccountField].Search(columns.GetAccount(row).ToString(), addCandidate);
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "AhoCorasick.h"
+#include "csv/CsvItem.h"
+#include "csv/CsvRule.h"
+
+#include <array>
+#include <vector>
+
+namespace hokee
+{
+/// Prefilter for rule matching. Every rule is keyed by the longest literal that one of its patterns requires.
+/// The keys are searched with one Aho-Corasick automaton per item field, so only rules whose key occurs in an
+/// item have to be evaluated. Rules without key are always candidates.
+class CsvRuleFilter
+{
+    enum Field
+    {
+        PayerPayeeField,
+        DescriptionField,
+        TypeField,
+        AccountField,
+        FieldCount
+    };
+
+    std::array<AhoCorasick, FieldCount> _automata{};
+    std::vector<size_t> _unfiltered{};
+
+  public:
+    CsvRuleFilter() = default;
+    ~CsvRuleFilter() = default;
+
+    CsvRuleFilter(const CsvRuleFilter&) = delete;
+    CsvRuleFilter& operator=(const CsvRuleFilter&) = delete;
+    CsvRuleFilter(CsvRuleFilter&&) = delete;
+    CsvRuleFilter& operator=(CsvRuleFilter&&) = delete;
+
+    void Build(const std::vector<CsvRule>& rules);
+
+    /// Ascending indices of the rules which may match the (lower case) row of the columns
+    void GetCandidates(const CsvColumns& columns, size_t row, std::vector<size_t>& candidates) const;
+
+    inline size_t GetUnfilteredCount() const
+    {
+        return _unfiltered.size();
+    }
+};
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "CsvScanner.h"
+#include "InternalException.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define HOKEE_CSV_SCANNER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HOKEE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HOKEE_TARGET_AVX2
+#endif
+
+namespace hokee
+{
+namespace
+{
+inline bool IsNonprintable(char c)
+{
+    const auto uc = static_cast<unsigned char>(c);
+    return (uc < 32 || uc > 126) && c != '\n' && c != '\r' && c != '\0';
+}
+
+inline int CountTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+inline void AppendPositions(uint32_t mask, size_t offset, std::vector<size_t>& positions)
+{
+    while (mask != 0)
+    {
+        positions.push_back(offset + static_cast<size_t>(CountTrailingZeros(mask)));
+        mask &= mask - 1;
+    }
+}
+
+void ScanScalar(char* base, size_t begin, size_t end, char delimiter, std::vector<size_t>& positions)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (IsNonprintable(base[i]))
+        {
+            base[i] = '_';
+        }
+        if (base[i] == delimiter || base[i] == '\n')
+        {
+            positions.push_back(i);
+        }
+    }
+}
+
+#ifdef HOKEE_CSV_SCANNER_X86
+void ScanSse2(char* base, size_t begin, size_t end, char delimiter, std::vector<size_t>& positions)
+{
+    const __m128i delimiters = _mm_set1_epi8(delimiter);
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i returns = _mm_set1_epi8('\r');
+    const __m128i zeros = _mm_setzero_si128();
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i dels = _mm_set1_epi8(127);
+
+    size_t i = begin;
+    for (; i + 16 <= end; i += 16)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + i));
+
+        // signed compare: bytes >= 128 are negative, i.e. nonprintable as well
+        const __m128i invalid = _mm_or_si128(_mm_cmplt_epi8(chars, spaces), _mm_cmpeq_epi8(chars, dels));
+        const __m128i allowed
+            = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, newlines), _mm_cmpeq_epi8(chars, returns)),
+                           _mm_cmpeq_epi8(chars, zeros));
+        if (_mm_movemask_epi8(_mm_andnot_si128(allowed, invalid)) != 0)
+        {
+            ScanScalar(base, i, i + 16, delimiter, positions);
+            continue;
+        }
+
+        const __m128i structural
+            = _mm_or_si128(_mm_cmpeq_epi8(chars, delimiters), _mm_cmpeq_epi8(chars, newlines));
+        AppendPositions(static_cast<uint32_t>(_mm_movemask_epi8(structural)), i, positions);
+    }
+    ScanScalar(base, i, end, delimiter, positions);
+}
+
+HOKEE_TARGET_AVX2 void ScanAvx2(char* base, size_t begin, size_t end, char delimiter,
+                                std::vector<size_t>& positions)
+{
+    const __m256i delimiters = _mm256_set1_epi8(delimiter);
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    const __m256i returns = _mm256_set1_epi8('\r');
+    const __m256i zeros = _mm256_setzero_si256();
+    const __m256i spaces = _mm256_set1_epi8(' ');
+    const __m256i dels = _mm256_set1_epi8(127);
+
+    size_t i = begin;
+    for (; i + 32 <= end; i += 32)
+    {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + i));
+
+        // signed compare: bytes >= 128 are negative, i.e. nonprintable as well
+        const __m256i invalid = _mm256_or_si256(_mm256_cmpgt_epi8(spaces, chars), _mm256_cmpeq_epi8(chars, dels));
+        const __m256i allowed = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, newlines), _mm256_cmpeq_epi8(chars, returns)),
+            _mm256_cmpeq_epi8(chars, zeros));
+        if (_mm256_movemask_epi8(_mm256_andnot_si256(allowed, invalid)) != 0)
+        {
+            ScanScalar(base, i, i + 32, delimiter, positions);
+            continue;
+        }
+
+        const __m256i structural
+            = _mm256_or_si256(_mm256_cmpeq_epi8(chars, delimiters), _mm256_cmpeq_epi8(chars, newlines));
+        AppendPositions(static_cast<uint32_t>(_mm256_movemask_epi8(structural)), i, positions);
+    }
+    ScanSse2(base, i, end, delimiter, positions);
+}
+
+bool HasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+using ScanFunction = void (*)(char*, size_t, size_t, char, std::vector<size_t>&);
+
+ScanFunction SelectScanFunction()
+{
+#ifdef HOKEE_CSV_SCANNER_X86
+#ifndef _MSC_VER
+    __builtin_cpu_init();
+#endif
+    if (HasAvx2())
+    {
+        return ScanAvx2;
+    }
+    return ScanSse2;
+#else
+    return ScanScalar;
+#endif
+}
+
+ScanFunction GetScanFunction()
+{
+    static const ScanFunction scan = SelectScanFunction();
+    return scan;
+}
+} // namespace
+
+CsvScanner::CsvScanner(char delimiter)
+    : _delimiter{delimiter}
+    , _scan{GetScanFunction()}
+{
+}
+
+CsvScanner::CsvScanner(char delimiter, InstructionSet instructionSet)
+    : _delimiter{delimiter}
+    , _scan{ScanScalar}
+{
+    const std::vector<InstructionSet> instructionSets = GetInstructionSets();
+    if (std::find(instructionSets.begin(), instructionSets.end(), instructionSet) == instructionSets.end())
+    {
+        throw InternalException(__FILE__, __LINE__,
+                                fmt::format("Instruction set {} is not supported.", GetName(instructionSet)));
+    }
+#ifdef HOKEE_CSV_SCANNER_X86
+    if (instructionSet == InstructionSet::Sse2)
+    {
+        _scan = ScanSse2;
+    }
+    else if (instructionSet == InstructionSet::Avx2)
+    {
+        _scan = ScanAvx2;
+    }
+#endif
+}
+
+void CsvScanner::Scan(char* base, size_t begin, size_t end, std::vector<size_t>& positions) const
+{
+    _scan(base, begin, end, _delimiter, positions);
+}
+
+const char* CsvScanner::GetInstructionSet()
+{
+#ifdef HOKEE_CSV_SCANNER_X86
+    return GetName(GetScanFunction() == ScanAvx2 ? InstructionSet::Avx2 : InstructionSet::Sse2);
+#else
+    return GetName(InstructionSet::Scalar);
+#endif
+}
+
+std::vector<CsvScanner::InstructionSet> CsvScanner::GetInstructionSets()
+{
+    std::vector<InstructionSet> instructionSets{InstructionSet::Scalar};
+#ifdef HOKEE_CSV_SCANNER_X86
+    instructionSets.push_back(InstructionSet::Sse2);
+    if (GetScanFunction() == ScanAvx2)
+    {
+        instructionSets.push_back(InstructionSet::Avx2);
+    }
+#endif
+    return instructionSets;
+}
+
+const char* CsvScanner::GetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::Sse2:
+        return "SSE2";
+    case InstructionSet::Avx2:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace hokee
+{
+/// Vectorized scanner (AVX2/SSE2 with scalar fallback) for the structural characters of a csv buffer.
+class CsvScanner
+{
+  public:
+    enum class InstructionSet
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+  private:
+    char _delimiter;
+    void (*_scan)(char*, size_t, size_t, char, std::vector<size_t>&);
+
+  public:
+    CsvScanner() = delete;
+
+    /// Uses the best instruction set of the cpu
+    explicit CsvScanner(char delimiter);
+
+    /// Throws for instruction sets the cpu does not support (see GetInstructionSets())
+    CsvScanner(char delimiter, InstructionSet instructionSet);
+    ~CsvScanner() = default;
+
+    CsvScanner(const CsvScanner&) = default;
+    CsvScanner& operator=(const CsvScanner&) = default;
+    CsvScanner(CsvScanner&&) = default;
+    CsvScanner& operator=(CsvScanner&&) = default;
+
+    /// Replaces nonprintable characters (except '\n', '\r' and '\0') by '_' and appends the offsets of all
+    /// delimiter and '\n' characters in [begin, end) to positions. Offsets are relative to base.
+    void Scan(char* base, size_t begin, size_t end, std::vector<size_t>& positions) const;
+
+    /// Name of the instruction set selected at runtime
+    static const char* GetInstructionSet();
+
+    /// Instruction sets supported by the cpu, the scalar one first
+    static std::vector<InstructionSet> GetInstructionSets();
+
+    static const char* GetName(InstructionSet instructionSet);
+};
+} // namespace hokee
\ No newline at end of file
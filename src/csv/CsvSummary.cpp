@@ -0,0 +1,100 @@
+#include "CsvSummary.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace hokee
+{
+const CsvSummary::Cell CsvSummary::EMPTY_CELL{};
+
+size_t CsvSummary::GetSlot(CsvSymbol category)
+{
+    if (category.GetId() >= _slots.size())
+    {
+        _slots.resize(category.GetId() + 1, SIZE_MAX);
+    }
+    size_t& slot = _slots[category.GetId()];
+    if (slot == SIZE_MAX)
+    {
+        // A category gets its cells with its first item, e.g. after a rule with a new category was saved
+        slot = _cells.size() / std::max<size_t>(1, GetCellsPerSlot());
+        _cells.resize(_cells.size() + GetCellsPerSlot());
+    }
+    return slot;
+}
+
+void CsvSummary::AddToSlot(size_t slot, int year, int month, int64_t value, int64_t count)
+{
+    Cell* yearCells = &_cells[slot * GetCellsPerSlot() + static_cast<size_t>(year - _minYear) * 13];
+    for (Cell* cell : {&yearCells[0], &yearCells[month]})
+    {
+        cell->Sum += count * value;
+        if (value >= 0)
+        {
+            cell->Income += count * value;
+        }
+        else
+        {
+            cell->Expense += count * value;
+        }
+        cell->Count += count;
+    }
+}
+
+void CsvSummary::Add(int year, int month, int64_t value, CsvSymbol category, int64_t count)
+{
+    if (month < 1)
+    {
+        // Items without date have no cell
+        return;
+    }
+    if (category.IsEmpty())
+    {
+        AddToSlot(GetSlot(category), year, month, value, 2 * count);
+        return;
+    }
+    if (category.ToString().back() != '!')
+    {
+        AddToSlot(GetSlot(CsvSymbol()), year, month, value, count);
+    }
+    AddToSlot(GetSlot(category), year, month, value, count);
+}
+
+void CsvSummary::Build(const CsvColumns& columns)
+{
+    _minYear = 3000;
+    _maxYear = 1900;
+    for (size_t r = 0; r < columns.GetSize(); ++r)
+    {
+        if (columns.GetMonth(r) >= 1)
+        {
+            _minYear = std::min(_minYear, columns.GetYear(r));
+            _maxYear = std::max(_maxYear, columns.GetYear(r));
+        }
+    }
+
+    _slots.clear();
+    _cells.clear();
+    for (size_t r = 0; r < columns.GetSize(); ++r)
+    {
+        Add(columns.GetYear(r), columns.GetMonth(r), columns.GetValue(r).GetCents(), columns.GetCategory(r), 1);
+    }
+}
+
+void CsvSummary::Move(int year, int month, int64_t value, CsvSymbol from, CsvSymbol to)
+{
+    Add(year, month, value, from, -1);
+    Add(year, month, value, to, 1);
+}
+
+const CsvSummary::Cell& CsvSummary::GetCell(CsvSymbol category, int year, int month) const
+{
+    if (category.GetId() >= _slots.size() || _slots[category.GetId()] == SIZE_MAX || year < _minYear
+        || year > _maxYear)
+    {
+        return EMPTY_CELL;
+    }
+    return _cells[_slots[category.GetId()] * GetCellsPerSlot() + static_cast<size_t>(year - _minYear) * 13
+                  + static_cast<size_t>(month)];
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "csv/CsvColumns.h"
+#include "csv/CsvSymbol.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace hokee
+{
+/// Sums of the summary page, stored densely by [category][year][month (0: whole year)]. The empty category is
+/// the "*" row of all categories except those ending with '!'. Unassigned items are counted twice in "*", as the
+/// summary page always did.
+/// Build after Data changed, then keep it up to date with Move() for every item whose category changed.
+class CsvSummary
+{
+  public:
+    /// Sums in cents and number of items of one summary cell
+    struct Cell
+    {
+        int64_t Sum{0};
+        /// Values >= 0
+        int64_t Income{0};
+        /// Values < 0
+        int64_t Expense{0};
+        int64_t Count{0};
+    };
+
+  private:
+    static const Cell EMPTY_CELL;
+
+    int _minYear{3000};
+    int _maxYear{1900};
+    std::vector<size_t> _slots{};
+    std::vector<Cell> _cells{};
+
+    inline size_t GetCellsPerSlot() const
+    {
+        return _maxYear >= _minYear ? static_cast<size_t>(_maxYear - _minYear + 1) * 13 : 0;
+    }
+
+    size_t GetSlot(CsvSymbol category);
+    void AddToSlot(size_t slot, int year, int month, int64_t value, int64_t count);
+    void Add(int year, int month, int64_t value, CsvSymbol category, int64_t count);
+
+  public:
+    CsvSummary() = default;
+    ~CsvSummary() = default;
+
+    CsvSummary(const CsvSummary&) = delete;
+    CsvSummary& operator=(const CsvSummary&) = delete;
+    CsvSummary(CsvSummary&&) = delete;
+    CsvSummary& operator=(CsvSummary&&) = delete;
+
+    void Build(const CsvColumns& columns);
+
+    /// Moves an item from the cells of one category to the cells of another one
+    void Move(int year, int month, int64_t value, CsvSymbol from, CsvSymbol to);
+
+    /// Empty cell for years outside of [GetMinYear(), GetMaxYear()] and categories without items
+    const Cell& GetCell(CsvSymbol category, int year, int month) const;
+
+    /// 3000, if there are no items
+    inline int GetMinYear() const
+    {
+        return _minYear;
+    }
+
+    /// 1900, if there are no items
+    inline int GetMaxYear() const
+    {
+        return _maxYear;
+    }
+};
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "CsvSymbol.h"
+#include "Utils.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace hokee
+{
+struct CsvSymbol::Table
+{
+    std::shared_mutex Mutex{};
+    std::deque<Entry> Entries{};
+    std::unordered_map<std::string_view, const Entry*> Index{};
+
+    /// Requires a shared or exclusive lock
+    const Entry* Find(std::string_view value) const
+    {
+        auto it = Index.find(value);
+        return it == Index.end() ? nullptr : it->second;
+    }
+
+    /// Requires an exclusive lock. lower == nullptr: value is lower case
+    const Entry* Add(std::string_view value, const Entry* lower)
+    {
+        // Ids start at 1, EMPTY is 0. Deque elements keep their address, so the index can view them
+        const auto id = static_cast<uint32_t>(Entries.size() + 1);
+        Entry& entry = Entries.emplace_back(Entry{std::string(value), id, lower});
+        if (lower == nullptr)
+        {
+            entry.Lower = &entry;
+        }
+        Index.emplace(entry.Value, &entry);
+        return &entry;
+    }
+};
+
+const CsvSymbol::Entry CsvSymbol::EMPTY{"", 0, &CsvSymbol::EMPTY};
+
+CsvSymbol::Table& CsvSymbol::GetTable()
+{
+    static Table table;
+    return table;
+}
+
+const CsvSymbol::Entry* CsvSymbol::Intern(std::string_view value)
+{
+    if (value.empty())
+    {
+        return &EMPTY;
+    }
+
+    Table& table = GetTable();
+    {
+        std::shared_lock lock(table.Mutex);
+        if (const Entry* entry = table.Find(value))
+        {
+            return entry;
+        }
+    }
+
+    const std::string lower = Utils::ToLower(std::string(value));
+    std::unique_lock lock(table.Mutex);
+    if (const Entry* entry = table.Find(value))
+    {
+        return entry;
+    }
+    if (lower == value)
+    {
+        return table.Add(value, nullptr);
+    }
+    const Entry* lowerEntry = table.Find(lower);
+    if (lowerEntry == nullptr)
+    {
+        lowerEntry = table.Add(lower, nullptr);
+    }
+    return table.Add(value, lowerEntry);
+}
+
+CsvSymbol::CsvSymbol(std::string_view value)
+    : _entry{Intern(value)}
+{
+}
+
+CsvSymbol::CsvSymbol(const std::string& value)
+    : _entry{Intern(value)}
+{
+}
+
+CsvSymbol::CsvSymbol(const char* value)
+    : _entry{Intern(value)}
+{
+}
+
+bool CsvSymbol::Find(std::string_view value, CsvSymbol& symbol)
+{
+    if (value.empty())
+    {
+        symbol = CsvSymbol();
+        return true;
+    }
+
+    Table& table = GetTable();
+    std::shared_lock lock(table.Mutex);
+    const Entry* entry = table.Find(value);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+    symbol = CsvSymbol(entry);
+    return true;
+}
+
+size_t CsvSymbol::GetCount()
+{
+    Table& table = GetTable();
+    std::shared_lock lock(table.Mutex);
+    return table.Entries.size() + 1;
+}
+
+std::ostream& operator<<(std::ostream& os, const CsvSymbol& symbol)
+{
+    os << symbol.ToString();
+    return os;
+}
+} // namespace hokee
\ No newline at end of file
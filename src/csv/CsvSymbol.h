@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace hokee
+{
+/// Interned string. Equal strings share one entry of a global, thread-safe symbol table, so symbols are compared
+/// by pointer and copied without allocation. Entries are never freed, ids are stable (0: empty string).
+class CsvSymbol
+{
+    struct Entry
+    {
+        std::string Value;
+        uint32_t Id;
+        const Entry* Lower;
+    };
+    struct Table;
+
+    static const Entry EMPTY;
+
+    const Entry* _entry{&EMPTY};
+
+    static Table& GetTable();
+    static const Entry* Intern(std::string_view value);
+
+    explicit CsvSymbol(const Entry* entry)
+        : _entry{entry}
+    {
+    }
+
+  public:
+    CsvSymbol() = default;
+    CsvSymbol(std::string_view value);
+    CsvSymbol(const std::string& value);
+    CsvSymbol(const char* value);
+    ~CsvSymbol() = default;
+
+    CsvSymbol(const CsvSymbol&) = default;
+    CsvSymbol& operator=(const CsvSymbol&) = default;
+    CsvSymbol(CsvSymbol&&) = default;
+    CsvSymbol& operator=(CsvSymbol&&) = default;
+
+    /// Returns false (and leaves symbol unchanged) if the value has not been interned yet
+    static bool Find(std::string_view value, CsvSymbol& symbol);
+
+    /// Number of interned strings, all ids are less than this
+    static size_t GetCount();
+
+    inline bool operator==(const CsvSymbol& rhs) const
+    {
+        return _entry == rhs._entry;
+    }
+
+    inline bool operator!=(const CsvSymbol& rhs) const
+    {
+        return _entry != rhs._entry;
+    }
+
+    inline const std::string& ToString() const
+    {
+        return _entry->Value;
+    }
+
+    inline uint32_t GetId() const
+    {
+        return _entry->Id;
+    }
+
+    inline bool IsEmpty() const
+    {
+        return _entry == &EMPTY;
+    }
+
+    /// Lower case symbol (interned together with the symbol, no allocation)
+    inline CsvSymbol ToLower() const
+    {
+        return CsvSymbol(_entry->Lower);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const CsvSymbol& symbol);
+};
+} // namespace hokee
\ No newline at end of file
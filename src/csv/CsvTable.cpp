@@ -1,95 +1,371 @@
 #include "CsvTable.h"
+#include "InternalException.h"
+#include "Utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <iterator>
 
 namespace hokee
 {
-int CsvTable::DeleteItem(int id)
+void CsvTable::UpdateIndex()
+{
+    _positions.clear();
+    _positions.reserve(_rows.size());
+    _sortedIds.clear();
+    _sortedIds.reserve(_rows.size());
+    for (size_t i = 0; i < _rows.size(); ++i)
+    {
+        _positions.try_emplace(_rows[i]->Id, i);
+        _sortedIds.push_back(_rows[i]->Id);
+    }
+    std::sort(_sortedIds.begin(), _sortedIds.end());
+}
+
+void CsvTable::AddToIndex(int id, size_t position)
+{
+    _positions.try_emplace(id, position);
+
+    // New rows mostly have the highest id
+    if (_sortedIds.empty() || _sortedIds.back() <= id)
+    {
+        _sortedIds.push_back(id);
+    }
+    else
+    {
+        _sortedIds.insert(std::upper_bound(_sortedIds.begin(), _sortedIds.end(), id), id);
+    }
+}
+
+const CsvRowShared& CsvTable::AddItem(int id)
 {
-    auto it = this->begin();
-    while (it != this->end())
+    if (_isView)
     {
-        if (!(*it))
+        throw InternalException(__FILE__, __LINE__, "Cannot add items to a table with rows of other tables.");
+    }
+    const size_t row = _columns->AddRow();
+
+    // Rows (including their shared_ptr control blocks) are placed in the arena of the columns
+    _rows.push_back(std::allocate_shared<CsvItem>(CsvArenaAllocator<CsvItem>(_columns->GetArena()), _columns, row));
+    _rows.back()->Id = id;
+    AddToIndex(id, _rows.size() - 1);
+    return _rows.back();
+}
+
+const CsvRowShared& CsvTable::AddItem(const CsvItem& item, int id)
+{
+    if (_isView)
+    {
+        throw InternalException(__FILE__, __LINE__, "Cannot add items to a table with rows of other tables.");
+    }
+    const size_t row = _columns->CopyRow(*item._columns, item._row);
+    _rows.push_back(std::allocate_shared<CsvItem>(CsvArenaAllocator<CsvItem>(_columns->GetArena()), _columns, row));
+    _rows.back()->Id = id;
+    AddToIndex(id, _rows.size() - 1);
+    return _rows.back();
+}
+
+void CsvTable::Add(CsvRowShared row)
+{
+    _isView = true;
+    const int id = row->Id;
+    _rows.push_back(std::move(row));
+    AddToIndex(id, _rows.size() - 1);
+}
+
+void CsvTable::Append(std::vector<CsvRowShared>&& rows)
+{
+    _isView = true;
+    AppendRows(std::move(rows));
+}
+
+void CsvTable::AppendRows(std::vector<CsvRowShared>&& rows)
+{
+    // No exact reserve, tables are appended run by run and must grow geometrically
+    const size_t sortedSize = _sortedIds.size();
+    for (auto& row : rows)
+    {
+        _positions.try_emplace(row->Id, _rows.size());
+        _sortedIds.push_back(row->Id);
+        _rows.push_back(std::move(row));
+    }
+    rows.clear();
+
+    auto middle = _sortedIds.begin() + static_cast<std::ptrdiff_t>(sortedSize);
+    std::sort(middle, _sortedIds.end());
+    std::inplace_merge(_sortedIds.begin(), middle, _sortedIds.end());
+}
+
+void CsvTable::Append(CsvTable&& other)
+{
+    if (_rows.empty() && !_isView && !other._isView)
+    {
+        // Take the columns as they are
+        std::swap(_columns, other._columns);
+    }
+    else if (!_isView && !other._isView)
+    {
+        const size_t offset = _columns->GetSize();
+        _columns->Append(std::move(*other._columns));
+        for (auto& row : other._rows)
         {
-            ++it;
-            continue;
+            row->_row += offset;
+            row->_columns = _columns;
         }
-        auto ref = (*it)->References.begin();
-        while (ref != (*it)->References.end())
+    }
+    else
+    {
+        for (auto& row : other._rows)
         {
-            if ((*ref) && (*ref)->Id == id)
+            if (row->_columns == other._columns)
             {
-                ref = (*it)->References.erase(ref);
-            }
-            else
-            {
-                ++ref;
+                row->_row = _columns->MoveRow(*other._columns, row->_row);
+                row->_columns = _columns;
             }
         }
+        _isView = true;
+    }
+    AppendRows(std::move(other._rows));
+    other.Clear();
+}
 
-        // If Id matches
-        if ((*it)->Id == id)
-        {
-            it = this->erase(it);
-            if (it != this->end() && (*it))
-            {
-                return (*it)->Id;
-            }
-            return this->PrevItem(id);
-        }
-        else
-        {
-            ++it;
-        }
+void CsvTable::Insert(std::vector<CsvRowShared>&& rows,
+                      const std::function<bool(const CsvRowShared&, const CsvRowShared&)>& less)
+{
+    _isView = true;
+    if (rows.empty())
+    {
+        return;
+    }
+    std::sort(rows.begin(), rows.end(), less);
+    const size_t sortedSize = _sortedIds.size();
+    for (auto& row : rows)
+    {
+        _sortedIds.push_back(row->Id);
+    }
+
+    // Rows before the first inserted one keep their positions
+    const size_t first =
+        static_cast<size_t>(std::upper_bound(_rows.begin(), _rows.end(), rows.front(), less) - _rows.begin());
+    std::vector<CsvRowShared> merged;
+    merged.reserve(_rows.size() + rows.size());
+    std::move(_rows.begin(), _rows.begin() + static_cast<std::ptrdiff_t>(first), std::back_inserter(merged));
+    std::merge(std::make_move_iterator(_rows.begin() + static_cast<std::ptrdiff_t>(first)),
+               std::make_move_iterator(_rows.end()), std::make_move_iterator(rows.begin()),
+               std::make_move_iterator(rows.end()), std::back_inserter(merged), less);
+    _rows.swap(merged);
+    for (size_t i = first; i < _rows.size(); ++i)
+    {
+        _positions[_rows[i]->Id] = i;
     }
-    return -1;
+
+    rows.clear();
+    auto middle = _sortedIds.begin() + static_cast<std::ptrdiff_t>(sortedSize);
+    std::sort(middle, _sortedIds.end());
+    std::inplace_merge(_sortedIds.begin(), middle, _sortedIds.end());
 }
 
-int CsvTable::NextItem(int id) const
+const CsvColumns& CsvTable::GetColumns() const
+{
+    if (_isView)
+    {
+        throw InternalException(__FILE__, __LINE__, "Table has rows of other tables.");
+    }
+    return *_columns;
+}
+
+CsvColumns& CsvTable::GetColumns()
 {
-    int next = -1;
-    for (auto& i : *this)
+    if (_isView)
     {
-        if (!i)
+        throw InternalException(__FILE__, __LINE__, "Table has rows of other tables.");
+    }
+    return *_columns;
+}
+
+void CsvTable::Clear()
+{
+    _rows.clear();
+    _columns = std::make_shared<CsvColumns>();
+    _isView = false;
+    _positions.clear();
+    _sortedIds.clear();
+}
+
+void CsvTable::Reserve(size_t size)
+{
+    _rows.reserve(size);
+    _positions.reserve(size);
+    _sortedIds.reserve(size);
+}
+
+void CsvTable::Reorder(const std::vector<size_t>& order)
+{
+    if (order.size() != _rows.size())
+    {
+        throw InternalException(__FILE__, __LINE__,
+                                fmt::format("Cannot reorder {} rows to {} positions.", _rows.size(), order.size()));
+    }
+
+    // The ids stay the same, only their positions change
+    const bool isColumnar = !_isView;
+    std::vector<CsvRowShared> rows(_rows.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        rows[i] = std::move(_rows[order[i]]);
+        _positions[rows[i]->Id] = i;
+        if (isColumnar)
         {
-            continue;
+            rows[i]->_row = i;
         }
-        if (i->Id > id && (next == -1 || i->Id < next))
+    }
+    _rows.swap(rows);
+    if (isColumnar)
+    {
+        _columns->Reorder(order);
+    }
+}
+
+void CsvTable::GenerateIds()
+{
+    for (auto& row : _rows)
+    {
+        row->Id = Utils::GenerateId();
+    }
+    UpdateIndex();
+}
+
+size_t CsvTable::FindPosition(int id) const
+{
+    auto it = _positions.find(id);
+    return it == _positions.end() ? SIZE_MAX : it->second;
+}
+
+CsvRowShared CsvTable::FindItem(int id) const
+{
+    const size_t position = FindPosition(id);
+    return position == SIZE_MAX ? nullptr : _rows[position];
+}
+
+int CsvTable::DeleteItem(int id)
+{
+    const size_t position = FindPosition(id);
+    if (position == SIZE_MAX)
+    {
+        return -1;
+    }
+
+    const bool isColumnar = !_isView;
+    if (isColumnar)
+    {
+        // Pages may still show the item, so it keeps a copy of its fields
+        CsvItem& item = *_rows[position];
+        auto columns = std::make_shared<CsvColumns>();
+        item._row = columns->CopyRow(*_columns, position);
+        item._columns = std::move(columns);
+        _columns->EraseRow(position);
+    }
+
+    _rows.erase(_rows.begin() + static_cast<std::ptrdiff_t>(position));
+    _positions.erase(id);
+    _sortedIds.erase(std::lower_bound(_sortedIds.begin(), _sortedIds.end(), id));
+    for (size_t i = position; i < _rows.size(); ++i)
+    {
+        _positions[_rows[i]->Id] = i;
+        if (isColumnar)
         {
-            next = i->Id;
+            _rows[i]->_row = i;
         }
     }
-    return next;
+
+    if (position < _rows.size())
+    {
+        return _rows[position]->Id;
+    }
+    return PrevItem(id);
 }
 
-int CsvTable::PrevItem(int id) const
+void CsvTable::DeleteItems(const std::vector<int>& ids)
 {
-    int prev = -1;
-    for (auto& i : *this)
+    std::vector<size_t> positions;
+    std::vector<int> removedIds;
+    for (int id : ids)
     {
-        if (!i)
+        const size_t position = FindPosition(id);
+        if (position != SIZE_MAX)
         {
-            continue;
+            positions.push_back(position);
+            removedIds.push_back(id);
         }
-        if (i->Id < id && (prev == -1 || i->Id > prev))
+    }
+    if (positions.empty())
+    {
+        return;
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    std::sort(removedIds.begin(), removedIds.end());
+    removedIds.erase(std::unique(removedIds.begin(), removedIds.end()), removedIds.end());
+
+    if (!_isView)
+    {
+        // Pages may still show the items, so they share one copy of their fields
+        auto columns = std::make_shared<CsvColumns>();
+        columns->Reserve(positions.size());
+        for (size_t position : positions)
         {
-            prev = i->Id;
+            CsvItem& item = *_rows[position];
+            item._row = columns->CopyRow(*_columns, position);
+            item._columns = columns;
         }
+        _columns->EraseRows(positions);
     }
-    return prev;
-}
 
-bool CsvTable::HasItem(int id) const
-{
-    for (auto& i : *this)
+    size_t target = positions.front();
+    auto removed = positions.begin();
+    for (size_t i = positions.front(); i < _rows.size(); ++i)
     {
-        if (!i)
+        if (removed != positions.end() && *removed == i)
         {
+            ++removed;
             continue;
         }
-        if (i->Id == id)
+        _rows[target] = std::move(_rows[i]);
+        _positions[_rows[target]->Id] = target;
+        if (!_isView)
         {
-            return true;
+            _rows[target]->_row = target;
         }
+        ++target;
     }
-    return false;
+    _rows.resize(target);
+
+    for (int id : removedIds)
+    {
+        _positions.erase(id);
+    }
+    auto isRemovedCallback = [&removedIds](int id)
+    {
+        return std::binary_search(removedIds.begin(), removedIds.end(), id);
+    };
+    _sortedIds.erase(std::remove_if(_sortedIds.begin(), _sortedIds.end(), isRemovedCallback), _sortedIds.end());
+}
+
+int CsvTable::NextItem(int id) const
+{
+    auto it = std::upper_bound(_sortedIds.begin(), _sortedIds.end(), id);
+    return it == _sortedIds.end() ? -1 : *it;
+}
+
+int CsvTable::PrevItem(int id) const
+{
+    auto it = std::lower_bound(_sortedIds.begin(), _sortedIds.end(), id);
+    return it == _sortedIds.begin() ? -1 : *(it - 1);
+}
+
+bool CsvTable::HasItem(int id) const
+{
+    return FindPosition(id) != SIZE_MAX;
 }
-} // namespace hokee
\ No newline at end of file
+} // namespace hokee
@@ -2,13 +2,45 @@
 
 #include "csv/CsvItem.h"
 
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
 namespace hokee
 {
-class CsvTable : public std::vector<CsvRowShared>
+/// Rows with an id index. All mutators keep the index valid, so lookups never scan the table.
+/// Rows created with AddItem() store their fields in the columns of the table. Other tables (e.g. Assigned) are
+/// views, which only refer to rows of these tables. A table becomes a view with the first row of another table and
+/// owns its rows again after Clear().
+class CsvTable
 {
+    std::vector<CsvRowShared> _rows{};
     std::vector<std::string> _header{};
+    std::shared_ptr<CsvColumns> _columns{std::make_shared<CsvColumns>()};
+
+    /// True, if the table refers to rows of other tables (see Add(), Append() and Insert()). Otherwise row r of
+    /// the table is row r of its columns.
+    bool _isView{false};
+
+    std::unordered_map<int, size_t> _positions{};
+    std::vector<int> _sortedIds{};
+
+    void UpdateIndex();
+    void AddToIndex(int id, size_t position);
+    void AppendRows(std::vector<CsvRowShared>&& rows);
 
   public:
+    typedef std::vector<CsvRowShared>::const_iterator const_iterator;
+
+    CsvTable() = default;
+    ~CsvTable() = default;
+
+    CsvTable(const CsvTable&) = delete;
+    CsvTable& operator=(const CsvTable&) = delete;
+    CsvTable(CsvTable&&) = default;
+    CsvTable& operator=(CsvTable&&) = default;
+
     inline const std::vector<std::string>& GetCsvHeader() const
     {
         return _header;
@@ -19,9 +51,102 @@ class CsvTable : public std::vector<CsvRowShared>
         _header = std::move(header);
     }
 
+    inline const std::vector<CsvRowShared>& GetRows() const
+    {
+        return _rows;
+    }
+
+    inline size_t size() const
+    {
+        return _rows.size();
+    }
+
+    inline bool empty() const
+    {
+        return _rows.empty();
+    }
+
+    inline const_iterator begin() const
+    {
+        return _rows.begin();
+    }
+
+    inline const_iterator end() const
+    {
+        return _rows.end();
+    }
+
+    inline const CsvRowShared& operator[](size_t position) const
+    {
+        return _rows[position];
+    }
+
+    inline const CsvRowShared& front() const
+    {
+        return _rows.front();
+    }
+
+    inline const CsvRowShared& back() const
+    {
+        return _rows.back();
+    }
+
+    /// False for views, which refer to rows of other tables
+    inline bool OwnsRows() const
+    {
+        return !_isView;
+    }
+
+    /// Appends a new, empty row to the table and its columns. Throws for views.
+    const CsvRowShared& AddItem(int id = -1);
+
+    /// Appends a copy of the fields of item to the table and its columns. Throws for views.
+    const CsvRowShared& AddItem(const CsvItem& item, int id);
+
+    /// Appends a row of another table and makes this table a view, set its id before
+    void Add(CsvRowShared row);
+
+    /// Appends rows of other tables and makes this table a view, set their ids before
+    void Append(std::vector<CsvRowShared>&& rows);
+
+    /// Moves the rows of other to the end of this table. Rows stored in the columns of other move to the columns
+    /// of this table. This table becomes a view, if other is one.
+    void Append(CsvTable&& other);
+
+    /// Inserts rows of other tables into this table, which is sorted by less, keeps it sorted and makes it a view
+    void Insert(std::vector<CsvRowShared>&& rows,
+                const std::function<bool(const CsvRowShared&, const CsvRowShared&)>& less);
+
+    /// Columns of all rows, row r of the columns belongs to row r of the table. Throws for views.
+    const CsvColumns& GetColumns() const;
+    CsvColumns& GetColumns();
+
+    /// Removes all rows, but keeps the csv header. Rows which are still referenced keep their columns. The table
+    /// owns its rows afterwards.
+    void Clear();
+    void Reserve(size_t size);
+
+    /// Moves the rows to the given order, row i is the row at position order[i] before
+    void Reorder(const std::vector<size_t>& order);
+
+    /// Assigns a new id to every row (see Utils::GenerateId())
+    void GenerateIds();
+
+    /// Position of the item with this id, SIZE_MAX if the table has no such item
+    size_t FindPosition(int id) const;
+
+    /// nullptr, if the table has no item with this id
+    CsvRowShared FindItem(int id) const;
+
+    /// Removes the item and returns the id of the next item (or of the previous one for the last item). A removed
+    /// item keeps a copy of its fields.
     int DeleteItem(int id);
+
+    /// Removes the items with one pass over the rows behind the first one, ids which are not in the table are
+    /// ignored. The removed items share one copy of their fields.
+    void DeleteItems(const std::vector<int>& ids);
     int NextItem(int id) const;
     int PrevItem(int id) const;
     bool HasItem(int id) const;
 };
-} // namespace hokee
\ No newline at end of file
+} // namespace hokee
@@ -0,0 +1,229 @@
+#include "CsvTextIndex.h"
+#include "InternalException.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <iterator>
+#include <numeric>
+
+namespace hokee
+{
+namespace
+{
+inline unsigned char LowerChar(char c)
+{
+    return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+inline uint32_t GetTrigram(std::string_view text, size_t i)
+{
+    return (static_cast<uint32_t>(LowerChar(text[i])) << 16) | (static_cast<uint32_t>(LowerChar(text[i + 1])) << 8)
+           | LowerChar(text[i + 2]);
+}
+
+void AddTrigrams(std::string_view text, std::vector<uint32_t>& trigrams)
+{
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+    {
+        trigrams.push_back(GetTrigram(text, i));
+    }
+}
+
+/// Case-insensitive search of a lower case word
+bool Contains(std::string_view text, std::string_view word)
+{
+    auto equalCallback = [](char a, char b)
+    {
+        return LowerChar(a) == static_cast<unsigned char>(b);
+    };
+    return std::search(text.begin(), text.end(), word.begin(), word.end(), equalCallback) != text.end();
+}
+} // namespace
+
+void CsvTextIndex::Build(const CsvColumns& columns)
+{
+    _postings.clear();
+    _size = columns.GetSize();
+
+    std::vector<uint32_t> trigrams;
+    for (size_t r = 0; r < columns.GetSize(); ++r)
+    {
+        trigrams.clear();
+        AddTrigrams(columns.GetPayerPayee(r), trigrams);
+        AddTrigrams(columns.GetDescription(r), trigrams);
+        AddTrigrams(columns.GetType(r).ToString(), trigrams);
+        AddTrigrams(columns.GetAccount(r).ToString(), trigrams);
+
+        // Rows are visited in order, so every posting list stays sorted
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        for (uint32_t trigram : trigrams)
+        {
+            _postings[trigram].push_back(static_cast<uint32_t>(r));
+        }
+    }
+}
+
+std::vector<uint32_t> CsvTextIndex::GetTextCandidates(std::string_view word) const
+{
+    // Intersect the shortest posting lists first
+    std::vector<const std::vector<uint32_t>*> postings;
+    for (size_t i = 0; i + 3 <= word.size(); ++i)
+    {
+        auto it = _postings.find(GetTrigram(word, i));
+        if (it == _postings.end())
+        {
+            return {};
+        }
+        postings.push_back(&it->second);
+    }
+    auto shorterCallback = [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b)
+    {
+        return a->size() < b->size();
+    };
+    std::sort(postings.begin(), postings.end(), shorterCallback);
+
+    std::vector<uint32_t> candidates = *postings[0];
+    std::vector<uint32_t> intersection;
+    for (size_t p = 1; p < postings.size() && !candidates.empty(); ++p)
+    {
+        intersection.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), postings[p]->begin(), postings[p]->end(),
+                              std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+    return candidates;
+}
+
+std::vector<size_t> CsvTextIndex::Find(const CsvColumns& columns, const std::vector<CsvSymbol>& categories,
+                                       std::string_view query) const
+{
+    if (columns.GetSize() != _size)
+    {
+        throw InternalException(__FILE__, __LINE__, "Text index is not up to date!");
+    }
+
+    const std::vector<std::string> words = SplitQuery(query);
+
+    // Every word with a trigram limits the candidates, the word with the fewest candidates is used. Shorter words
+    // are only checked by Match().
+    std::vector<uint32_t> candidates;
+    bool hasCandidates = false;
+    for (const auto& word : words)
+    {
+        if (word.size() < 3)
+        {
+            continue;
+        }
+
+        std::vector<uint32_t> wordCandidates = GetTextCandidates(word);
+        std::vector<CsvSymbol> matchingCategories;
+        for (const auto& category : categories)
+        {
+            if (Contains(category.ToString(), word))
+            {
+                matchingCategories.push_back(category);
+            }
+        }
+        if (!matchingCategories.empty())
+        {
+            std::vector<uint32_t> categoryRows;
+            for (size_t r = 0; r < columns.GetSize(); ++r)
+            {
+                if (std::find(matchingCategories.begin(), matchingCategories.end(), columns.GetCategory(r))
+                    != matchingCategories.end())
+                {
+                    categoryRows.push_back(static_cast<uint32_t>(r));
+                }
+            }
+            std::vector<uint32_t> merged;
+            std::set_union(wordCandidates.begin(), wordCandidates.end(), categoryRows.begin(), categoryRows.end(),
+                           std::back_inserter(merged));
+            wordCandidates.swap(merged);
+        }
+
+        if (!hasCandidates || wordCandidates.size() < candidates.size())
+        {
+            candidates.swap(wordCandidates);
+            hasCandidates = true;
+        }
+    }
+
+    std::vector<size_t> positions;
+    if (hasCandidates)
+    {
+        for (uint32_t r : candidates)
+        {
+            if (Match(columns, r, words))
+            {
+                positions.push_back(r);
+            }
+        }
+    }
+    else
+    {
+        for (size_t r = 0; r < columns.GetSize(); ++r)
+        {
+            if (Match(columns, r, words))
+            {
+                positions.push_back(r);
+            }
+        }
+    }
+    return positions;
+}
+
+std::vector<size_t> CsvTextIndex::GetCandidates(const CsvColumns& columns, std::string_view literal) const
+{
+    std::vector<size_t> rows;
+    if (literal.size() < 3 || columns.GetSize() != _size)
+    {
+        rows.resize(columns.GetSize());
+        std::iota(rows.begin(), rows.end(), 0);
+        return rows;
+    }
+    const std::vector<uint32_t> candidates = GetTextCandidates(literal);
+    rows.assign(candidates.begin(), candidates.end());
+    return rows;
+}
+
+std::vector<std::string> CsvTextIndex::SplitQuery(std::string_view query)
+{
+    std::vector<std::string> words;
+    size_t begin = 0;
+    while (begin < query.size())
+    {
+        size_t end = query.find(' ', begin);
+        if (end == std::string_view::npos)
+        {
+            end = query.size();
+        }
+        if (end > begin)
+        {
+            std::string word{query.substr(begin, end - begin)};
+            for (char& c : word)
+            {
+                c = static_cast<char>(LowerChar(c));
+            }
+            words.push_back(std::move(word));
+        }
+        begin = end + 1;
+    }
+    return words;
+}
+
+bool CsvTextIndex::Match(const CsvColumns& columns, size_t row, const std::vector<std::string>& words)
+{
+    for (const auto& word : words)
+    {
+        if (!Contains(columns.GetPayerPayee(row), word) && !Contains(columns.GetDescription(row), word)
+            && !Contains(columns.GetType(row).ToString(), word) && !Contains(columns.GetAccount(row).ToString(), word)
+            && !Contains(columns.GetCategory(row).ToString(), word))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace hokee
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "csv/CsvColumns.h"
+#include "csv/CsvItem.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hokee
+{
+/// Trigram index for the search on table pages. Every trigram of PayerPayee, Description, Type and Account maps to
+/// the ascending positions of the rows which contain it. Categories change with every rule edit, so they are not
+/// indexed but matched against the few category names and the categories column.
+/// Rebuild after Data changed.
+class CsvTextIndex
+{
+    std::unordered_map<uint32_t, std::vector<uint32_t>> _postings{};
+    size_t _size{0};
+
+    /// Ascending positions of the rows, whose indexed fields contain all trigrams of the word
+    std::vector<uint32_t> GetTextCandidates(std::string_view word) const;
+
+  public:
+    CsvTextIndex() = default;
+    ~CsvTextIndex() = default;
+
+    CsvTextIndex(const CsvTextIndex&) = delete;
+    CsvTextIndex& operator=(const CsvTextIndex&) = delete;
+    CsvTextIndex(CsvTextIndex&&) = delete;
+    CsvTextIndex& operator=(CsvTextIndex&&) = delete;
+
+    void Build(const CsvColumns& columns);
+
+    /// Ascending rows of the columns which match the query (see Match()). The categories are those of the rules.
+    std::vector<size_t> Find(const CsvColumns& columns, const std::vector<CsvSymbol>& categories,
+                             std::string_view query) const;
+
+    /// Ascending rows of the columns, whose indexed fields contain all trigrams of the literal. Prefilter for the rows
+    /// a rule pattern can match: all rows for literals with less than three characters or columns which were not
+    /// indexed.
+    std::vector<size_t> GetCandidates(const CsvColumns& columns, std::string_view literal) const;
+
+    /// Lower case, non-empty words of the query (separated by spaces)
+    static std::vector<std::string> SplitQuery(std::string_view query);
+
+    /// True, if every word occurs in PayerPayee, Description, Type, Account or Category (case-insensitive)
+    static bool Match(const CsvColumns& columns, size_t row, const std::vector<std::string>& words);
+
+    static inline bool Match(const CsvItem& item, const std::vector<std::string>& words)
+    {
+        return Match(item.GetColumns(), item.GetRow(), words);
+    }
+
+    inline size_t GetTrigramCount() const
+    {
+        return _postings.size();
+    }
+};
+} // namespace hokee
\ No newline at end of file
@@ -1,62 +1,114 @@
 #include "CsvValue.h"
-#include "InternalException.h"
+#include "UserException.h"
 #include "Utils.h"
 
 #include <cstdint>
 #include <string>
-#include <algorithm>
 #include <fmt/format.h>
 
 namespace hokee
 {
-CsvValue::CsvValue(const std::string& value, const std::string& file, int lineCounter, bool validate)
-    : _string{value}
+namespace
 {
-    // Fix value
-    _string.erase(std::remove(_string.begin(), _string.end(), '_'), _string.end());
-    _string.erase(std::remove(_string.begin(), _string.end(), ' '), _string.end());
-    size_t pos = _string.find_last_of(".,");
-    if (pos == std::string::npos)
+/// Digits of the largest value which fits into int64_t with some headroom for sums
+constexpr int MAX_DIGITS = 17;
+} // namespace
+
+CsvValue::CsvValue(std::string_view value, const fs::path& file, int lineCounter, bool validate)
+{
+    int64_t units = 0;
+    int digits = 0;
+    int decimals = 0;
+    bool isNegative = false;
+    char separator = '\0';
+    int separatorCount = 0;
+
+    for (size_t i = 0; i < value.size(); ++i)
     {
-        if (!_string.empty())
+        const char c = value[i];
+        if (c >= '0' && c <= '9')
         {
-            _string += ".00";
+            if (++digits > MAX_DIGITS)
+            {
+                throw UserException(fmt::format("Value '{}' is too large", value), file, lineCounter);
+            }
+            units = units * 10 + (c - '0');
+            ++decimals;
         }
-    }
-    else
-    {
-        if (_string[pos] == ',')
+        else if (c == '.' || c == ',')
+        {
+            // The last separator is the decimal separator, the other one separates thousands
+            if (c == separator)
+            {
+                ++separatorCount;
+            }
+            else
+            {
+                separator = c;
+                separatorCount = 1;
+            }
+            decimals = 0;
+        }
+        else if ((c == '-' || c == '+') && digits == 0 && separator == '\0' && !isNegative)
         {
-            _string.erase(std::remove(_string.begin(), _string.end(), '.'), _string.end());
-            std::replace(_string.begin(), _string.end(), ',', '.');
+            isNegative = c == '-';
         }
-        else
+        else if (c != '_' && c != ' ')
         {
-            _string.erase(std::remove(_string.begin(), _string.end(), ','), _string.end());
+            throw UserException(fmt::format("Could not convert '{}' to a value", value), file, lineCounter);
         }
     }
 
-    // Validate value
-    if (_string.empty())
+    if (digits == 0)
     {
+        if (separator != '\0' || isNegative)
+        {
+            throw UserException(fmt::format("Could not convert '{}' to a value", value), file, lineCounter);
+        }
         return;
     }
-    try
+    if (separatorCount > 1)
     {
-        _value = std::stod(_string);
-        _string = fmt::format("{:.2f}", _value);
+        throw UserException(fmt::format("Could not convert '{}' to a value, ambiguous separators", value), file,
+                            lineCounter);
     }
-    catch (const std::exception& e)
+    if (separator == '\0')
+    {
+        decimals = 0;
+    }
+
+    if (decimals > 2)
     {
-        throw InternalException(__FILE__, __LINE__,
-                                fmt::format("Could not convert '{}' to 'double'. ({})", _string, e.what()));
+        if (validate)
+        {
+            throw UserException(fmt::format("Value '{}' has more than two decimal places", value), file,
+                                lineCounter);
+        }
+        int64_t divisor = 1;
+        for (int d = 2; d < decimals; ++d)
+        {
+            divisor *= 10;
+        }
+        units = (units + divisor / 2) / divisor;
     }
-    if (validate && _string != fmt::format("{:.2f}", _value))
+    for (int d = decimals; d < 2; ++d)
     {
-        throw UserException(
-            fmt::format("Could not parse converted value {} != stod({})", _string, fmt::format("{:.2f}", _value)),
-            file, lineCounter);
-    };
+        units *= 10;
+    }
+
+    _cents = isNegative ? -units : units;
+    _isEmpty = false;
+}
+
+std::string CsvValue::ToString() const
+{
+    return _isEmpty ? std::string{} : FormatCents(_cents);
+}
+
+std::string CsvValue::FormatCents(int64_t cents)
+{
+    const uint64_t absolute = cents < 0 ? 0 - static_cast<uint64_t>(cents) : static_cast<uint64_t>(cents);
+    return fmt::format("{}{}.{:02}", cents < 0 ? "-" : "", absolute / 100, absolute % 100);
 }
 
 std::ostream& operator<<(std::ostream& os, const CsvValue& value)
@@ -1,20 +1,26 @@
 #pragma once
 
+#include "../Filesystem.h"
+
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <string_view>
 
 namespace hokee
 {
+/// Monetary value in fixed point integer cents. The text is only formatted when it is rendered.
 class CsvValue
 {
-    double _value = 0;
-    std::string _string = "";
+    int64_t _cents = 0;
+    bool _isEmpty = true;
 
   public:
     CsvValue() = default;
 
-    CsvValue(const std::string& value, const std::string& file, int lineCounter, bool validate = true);
+    /// Accepts ',' and '.' as thousands and decimal separators, the last one is the decimal separator.
+    /// With validate more than two decimal places are rejected, otherwise they are rounded.
+    CsvValue(std::string_view value, const fs::path& file, int lineCounter, bool validate = true);
     ~CsvValue() = default;
 
     CsvValue(const CsvValue&) = default;
@@ -22,16 +28,37 @@ class CsvValue
     CsvValue(CsvValue&&) = default;
     CsvValue& operator=(CsvValue&&) = default;
 
-    inline const std::string& ToString() const
+    /// Formats "-1234.56", "" for an empty value
+    std::string ToString() const;
+
+    inline double ToDouble() const
     {
-        return _string;
+        return static_cast<double>(_cents) / 100;
     };
 
-    inline double ToDouble() const
+    inline int64_t GetCents() const
     {
-        return _value;
+        return _cents;
     };
-    
+
+    inline bool IsEmpty() const
+    {
+        return _isEmpty;
+    };
+
+    inline bool operator==(const CsvValue& rhs) const
+    {
+        return _cents == rhs._cents && _isEmpty == rhs._isEmpty;
+    };
+
+    inline bool operator!=(const CsvValue& rhs) const
+    {
+        return !(*this == rhs);
+    };
+
+    /// Formats cents as "-1234.56"
+    static std::string FormatCents(int64_t cents);
+
     friend std::ostream& operator<<(std::ostream& os, const CsvValue& value);
 };
 
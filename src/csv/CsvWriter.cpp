@@ -32,13 +32,13 @@ void CsvWriter::Write(const fs::path& file, const CsvTable& data)
     
     for (auto& row : data)
     {
-        csvFile << row->Category << ';';
-        csvFile << row->PayerPayee << ';';
-        csvFile << row->Description << ';';
-        csvFile << row->Type << ';';
-        csvFile << row->Date << ';';
-        csvFile << row->Account << ';';
-        csvFile << row->Value;
+        csvFile << row->GetCategory() << ';';
+        csvFile << row->GetPayerPayee() << ';';
+        csvFile << row->GetDescription() << ';';
+        csvFile << row->GetType() << ';';
+        csvFile << row->GetDate() << ';';
+        csvFile << row->GetAccount() << ';';
+        csvFile << row->GetValue();
         csvFile << std::endl;
     }
     csvFile.close();
@@ -7,201 +7,258 @@
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <iterator>
-#include <map>
 #include <memory>
+#include <vector>
 
 namespace hokee
 {
-HtmlElement* HtmlGenerator::AddButton(HtmlElement* tableRow, const std::string& link, const std::string& tooltip,
-                                      const std::string& image, const std::string& text, const std::string& style)
+void HtmlGenerator::AddButton(HtmlWriter& html, const std::string& link, const std::string& tooltip,
+                              const std::string& image, const std::string& text, const std::string& style)
 {
-    auto cell = tableRow->AddTableCell();
-    cell->SetAttribute("class", std::string("nav link ") + style);
+    html.Open("td");
+    html.Attribute("class", std::string("nav link ") + style);
     if (!link.empty())
     {
-        cell->SetAttribute("onclick", fmt::format("window.location='{}'", link));
+        html.Attribute("onclick", fmt::format("window.location='{}'", link));
     }
-    cell->SetAttribute("title", tooltip);
-    cell->AddImage(image, tooltip, 42);
-    cell->AddText(text);
-    return cell;
+    html.Attribute("title", tooltip);
+    html.Image(image, tooltip, 42);
+    html.Text(text);
+    html.Close();
 }
 
-HtmlElement* HtmlGenerator::AddNavigationHeader(HtmlElement* body, const CsvDatabase& database)
+void HtmlGenerator::OpenNavigationHeader(HtmlWriter& html, const CsvDatabase& database)
 {
-    auto box = body->AddDivision();
-    box->SetAttribute("class", "nav");
-    auto div = box->AddDivision();
-    div->SetAttribute("class", "box");
+    html.Open("div");
+    html.Attribute("class", "nav");
+    html.Open("div");
+    html.Attribute("class", "box");
 
-    auto table = div->AddTable();
-    table->SetAttribute("class", "nav");
-    auto row = table->AddTableRow();
+    html.Open("table");
+    html.Attribute("class", "nav");
+    html.Open("tr");
 
-    AddButton(row, INDEX_HTML, "Show Summary", "48-file-excel.png", "Summary &nbsp;");
-    AddButton(row, ALL_HTML, "Show All Items", "48-search.png", fmt::format("Items ({})", database.Data.size()));
-    AddButton(row, RULES_HTML, "Show Rules", "48-file-exe.png", fmt::format("Rules ({})", database.Rules.size()));
+    AddButton(html, INDEX_HTML, "Show Summary", "48-file-excel.png", "Summary &nbsp;");
+    AddButton(html, ALL_HTML, "Show All Items", "48-search.png", fmt::format("Items ({})", database.Data.size()));
+    AddButton(html, RULES_HTML, "Show Rules", "48-file-exe.png", fmt::format("Rules ({})", database.Rules.size()));
 
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", std::string("nav"));
-    div = cell->AddDivision();
-    div->SetAttribute("style", "width: 24px;");
+    html.Open("td");
+    html.Attribute("class", "nav");
+    html.Element("div", {}, {{"style", "width: 24px;"}});
+    html.Close();
 
     if (database.Unassigned.size() == 0 && database.Issues.size() == 0)
     {
-        AddButton(row, ASSIGNED_HTML, "Show Assigned Items", "48-shield-ok.png",
+        AddButton(html, ASSIGNED_HTML, "Show Assigned Items", "48-shield-ok.png",
                   fmt::format("Assigned ({})", database.Assigned.size()));
     }
     else
     {
-        AddButton(row, ASSIGNED_HTML, "Show Assigned Items", "48-shield-ok.png",
+        AddButton(html, ASSIGNED_HTML, "Show Assigned Items", "48-shield-ok.png",
                   fmt::format("Assigned ({})", database.Assigned.size()), "gray");
     }
 
     if (database.Unassigned.size() == 0)
     {
-        AddButton(row, UNASSIGNED_HTML, "Show Unassigned Items", "48-shield-warning.png",
+        AddButton(html, UNASSIGNED_HTML, "Show Unassigned Items", "48-shield-warning.png",
                   fmt::format("Warnings ({})", database.Unassigned.size()), "gray");
     }
     else
     {
-        AddButton(row, UNASSIGNED_HTML, "Show Unassigned Items", "48-shield-warning.png",
+        AddButton(html, UNASSIGNED_HTML, "Show Unassigned Items", "48-shield-warning.png",
                   fmt::format("Warnings ({})", database.Unassigned.size()));
     }
 
     if (database.Issues.size() == 0)
     {
-        AddButton(row, ISSUES_HTML, "Show Issues", "48-shield-error.png",
+        AddButton(html, ISSUES_HTML, "Show Issues", "48-shield-error.png",
                   fmt::format("Errors ({})", database.Issues.size()), "gray");
     }
     else
     {
-        AddButton(row, ISSUES_HTML, "Show Issues", "48-shield-error.png",
+        AddButton(html, ISSUES_HTML, "Show Issues", "48-shield-error.png",
                   fmt::format("Errors ({})", database.Issues.size()));
     }
 
-    cell = row->AddTableCell("&nbsp;");
-    cell->SetAttribute("class", "nav fill");
+    html.Element("td", "&nbsp;", {{"class", "nav fill"}});
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "nav");
-    cell->AddBold("hookee");
-    cell->AddText(PROJECT_VERSION_SHORT);
+    html.Open("td");
+    html.Attribute("class", "nav");
+    html.Element("b", "hookee");
+    html.Text(PROJECT_VERSION_SHORT);
+    html.Close();
 
-    cell = row->AddTableCell("&nbsp;");
-    cell->SetAttribute("class", "nav fill");
+    html.Element("td", "&nbsp;", {{"class", "nav fill"}});
 
-    AddButton(row, SETTINGS_HTML, "Open Settings File", "48-cogs.png", "Settings");
-    AddButton(row, SUPPORT_HTML, "Generate Support Mail", "48-profile.png", "Support");
-    AddButton(row, BACKUP_HTML, "Backup Rules", "48-safe.png", "Backup");
-    AddButton(row, INPUT_CMD, "Open Input Folder", "48-folder.png", "Input");
-    AddButton(row, HELP_HTML, "Open Online Help", "48-sign-question.png", "Help");
-    auto reload = AddButton(row, "", "Reload CSV Data", "48-sign-sync.png", "Reload");
-    reload->SetAttribute("onclick", fmt::format("reload('{}')", RELOAD_CMD));
-    body->AddScript("reload.js");
-    AddButton(row, EXIT_CMD, "Stop hokee", "48-sign-exit.png", "Exit");
+    AddButton(html, SETTINGS_HTML, "Open Settings File", "48-cogs.png", "Settings");
+    AddButton(html, SUPPORT_HTML, "Generate Support Mail", "48-profile.png", "Support");
+    AddButton(html, BACKUP_HTML, "Backup Rules", "48-safe.png", "Backup");
+    AddButton(html, INPUT_CMD, "Open Input Folder", "48-folder.png", "Input");
+    AddButton(html, HELP_HTML, "Open Online Help", "48-sign-question.png", "Help");
 
-    return box;
+    html.Open("td");
+    html.Attribute("class", "nav link ");
+    html.Attribute("title", "Reload CSV Data");
+    html.Attribute("onclick", fmt::format("reload('{}')", RELOAD_CMD));
+    html.Image("48-sign-sync.png", "Reload CSV Data", 42);
+    html.Text("Reload");
+    html.Close();
+
+    AddButton(html, EXIT_CMD, "Stop hokee", "48-sign-exit.png", "Exit");
+
+    html.Close(); // tr
+    html.Close(); // table
+    html.Close(); // div.box
+}
+
+void HtmlGenerator::CloseNavigationHeader(HtmlWriter& html)
+{
+    html.Close(); // div.nav
+    html.Script("reload.js");
 }
 
-HtmlElement* HtmlGenerator::AddHtmlHead(HtmlElement* html)
+void HtmlGenerator::AddHtmlHead(HtmlWriter& html, bool refresh)
 {
-    auto head = html->AddHead();
-    head->AddTitle("hokee");
-    auto meta = head->AddMeta();
-    meta->SetAttribute("name", "hokee");
-    meta->SetAttribute("content", "Summary");
-    meta = head->AddMeta();
-    meta->SetAttribute("charset", "UTF-8");
-
-    auto link = head->AddLink();
-    link->SetAttribute("rel", "apple-touch-icon");
-    link->SetAttribute("sizes", "180x180");
-    link->SetAttribute("href", "/apple-touch-icon.png");
-
-    link = head->AddLink();
-    link->SetAttribute("rel", "icon");
-    link->SetAttribute("type", "image/png");
-    link->SetAttribute("sizes", "32x32");
-    link->SetAttribute("href", "/favicon-32x32.png");
-
-    link = head->AddLink();
-    link->SetAttribute("rel", "icon");
-    link->SetAttribute("type", "image/png");
-    link->SetAttribute("sizes", "16x16");
-    link->SetAttribute("href", "/favicon-16x16.png");
-
-    link = head->AddLink();
-    link->SetAttribute("rel", "mask-icon");
-    link->SetAttribute("href", "/safari-pinned-tab.svg");
-    link->SetAttribute("color", "#5bbad5");
-
-    link = head->AddLink();
-    link->SetAttribute("rel", "stylesheet");
-    link->SetAttribute("href", "/stylesheet.css");
-
-    return head;
+    html.Open("head");
+    html.Element("title", "hokee");
+    html.Element("meta", {}, {{"name", "hokee"}, {"content", "Summary"}});
+    html.Element("meta", {}, {{"charset", "UTF-8"}});
+
+    html.Element("link", {},
+                 {{"rel", "apple-touch-icon"}, {"sizes", "180x180"}, {"href", "/apple-touch-icon.png"}});
+    html.Element("link", {},
+                 {{"rel", "icon"}, {"type", "image/png"}, {"sizes", "32x32"}, {"href", "/favicon-32x32.png"}});
+    html.Element("link", {},
+                 {{"rel", "icon"}, {"type", "image/png"}, {"sizes", "16x16"}, {"href", "/favicon-16x16.png"}});
+    html.Element("link", {}, {{"rel", "mask-icon"}, {"href", "/safari-pinned-tab.svg"}, {"color", "#5bbad5"}});
+    html.Element("link", {}, {{"rel", "stylesheet"}, {"href", "/stylesheet.css"}});
+
+    if (refresh)
+    {
+        html.Element("meta", {}, {{"http-equiv", "refresh"}, {"content", "0.5"}});
+    }
+    html.Close();
 }
 
-void HtmlGenerator::AddItemTableHeader(HtmlElement* table)
+void HtmlGenerator::AddItemTableHeader(HtmlWriter& html)
 {
-    auto row = table->AddTableRow();
-    row->AddTableHeaderCell("#");
-    row->AddTableHeaderCell("Category");
-    row->AddTableHeaderCell("Payer/Payee");
-    row->AddTableHeaderCell("Description");
-    row->AddTableHeaderCell("Type");
-    row->AddTableHeaderCell("Date");
-    row->AddTableHeaderCell("Account");
-    row->AddTableHeaderCell("Value");
+    html.Open("tr");
+    html.Element("th", "#");
+    html.Element("th", "Category");
+    html.Element("th", "Payer/Payee");
+    html.Element("th", "Description");
+    html.Element("th", "Type");
+    html.Element("th", "Date");
+    html.Element("th", "Account");
+    html.Element("th", "Value");
+    html.Close();
 }
 
-void HtmlGenerator::AddSummaryTableHeader(HtmlElement* table, int minYear, int maxYear)
+void HtmlGenerator::AddSummaryTableHeader(HtmlWriter& html, int minYear, int maxYear)
 {
-    auto row = table->AddTableRow();
+    html.Open("tr");
+    for (int year = minYear; year <= maxYear; ++year)
+    {
+        html.Attribute("class", "year");
+    }
 
     for (int year = minYear; year <= maxYear; ++year)
     {
         std::string name = fmt::format("{}", year);
-        auto cell = row->AddTableHeaderCell(name);
-        cell->SetAttribute("class", "item");
+        html.Element("th", name, {{"class", "item"}});
 
         for (int month = 1; month <= 12; ++month)
         {
             name = fmt::format("{:02}", month);
-
-            cell = row->AddTableHeaderCell(name);
-            cell->SetAttribute("class", "item");
+            html.Element("th", name, {{"class", "item"}});
         }
 
-        row->SetAttribute("class", "year");
         name = fmt::format("{}", year);
-        cell = row->AddTableHeaderCell(name);
-        cell->SetAttribute("class", "item");
+        html.Element("th", name, {{"class", "item"}});
+    }
+    html.Element("th");
+    html.Close();
+}
+
+namespace
+{
+/// Navigation cell with a linked image, or with the empty image if there is no link
+void AddNavigationCell(HtmlWriter& html, const std::string& link, const std::string& title,
+                       const std::string& image, const std::string& emptyTitle, const std::string& emptyImage)
+{
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Open("div");
+    html.Attribute("class", "box");
+    if (!link.empty())
+    {
+        html.HyperlinkImage(link, title, image, 38);
+    }
+    else
+    {
+        html.Image(emptyImage, emptyTitle, 38);
+    }
+    html.Close();
+    html.Close();
+}
+
+std::string GetItemLink(int id)
+{
+    return id >= 0 ? fmt::format("{}?id={}", HtmlGenerator::ITEM_HTML, id) : "";
+}
+
+/// Link to the window of a paginated table page
+std::string GetWindowLink(const std::string& link, size_t offset, size_t limit)
+{
+    return fmt::format("{}{}offset={}&amp;limit={}", link, link.find('?') == std::string::npos ? "?" : "&amp;",
+                       offset, limit);
+}
+
+std::string GetRowStyle(const CsvItem* row)
+{
+    std::string rowStyle = "link";
+    if (row->References.size() == 0)
+    {
+        rowStyle += " unassigned";
     }
-    row->AddTableHeaderCell("");
+    if (row->Issues.size() > 0)
+    {
+        rowStyle += " issue";
+    }
+    return rowStyle;
 }
 
-void AddSummaryCell(HtmlElement* row, int rowCount, const std::string& category, int month, int year,
-                    std::map<int, std::map<int, std::map<std::string, CsvTable>>>& sortedTables, int filter)
+std::string GetValueStyle(const CsvItem* row)
 {
-    double sum = 0;
-    for (auto& item : sortedTables[year][month][category])
+    try
     {
-        if ((!item->Category.empty() && item->Category.back() == '!') && category != item->Category)
+        if (row->GetValue().GetCents() < 0)
         {
-            continue;
+            return "neg";
         }
-        const double value = item->Value.ToDouble();
-        if ((filter == 0) || (filter >= 0 && value >= 0) || (filter < 0 && value < 0))
+        else if (row->GetValue().GetCents() > 0)
         {
-            sum += value;
+            return "pos";
         }
     }
+    catch (const std::exception&)
+    {
+    }
+    return "";
+}
+} // namespace
+
+void AddSummaryCell(HtmlWriter& html, int rowCount, const CsvSummary& summary, CsvSymbol category, int month,
+                    int year, int filter)
+{
+    const CsvSummary::Cell& cell = summary.GetCell(category, year, month);
+    const int64_t sum = filter < 0 ? cell.Expense : (filter > 0 ? cell.Income : cell.Sum);
 
     std::string cellStyle = "link";
     if (sum > 0)
@@ -217,138 +274,163 @@ void AddSummaryCell(HtmlElement* row, int rowCount, const std::string& category,
         cellStyle += fmt::format(" year");
     }
 
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", cellStyle);
-    cell->SetAttribute("onclick",
-                       fmt::format("window.location='{}?year={}&amp;month={}&amp;category={}&amp;filter={}';",
-                                   HtmlGenerator::ITEMS_HTML, year, month, category, filter));
-    cell->AddText(fmt::format("{:.2f}&euro;", sum));
+    html.Open("td");
+    html.Attribute("class", cellStyle);
+    html.Attribute("onclick",
+                   fmt::format("window.location='{}?year={}&amp;month={}&amp;category={}&amp;filter={}';",
+                               HtmlGenerator::ITEMS_HTML, year, month, category.ToString(), filter));
+    html.Text(CsvValue::FormatCents(sum) + "&euro;");
+    html.Close();
 }
 
-void AddSummaryRow(HtmlElement* table, int rowCount, int minYear, int maxYear, const std::string& category,
-                   std::map<int, std::map<int, std::map<std::string, CsvTable>>>& sortedTables, int filter,
+void AddSummaryRow(HtmlWriter& html, int rowCount, const CsvSummary& summary, CsvSymbol category, int filter,
                    const std::string& title)
 {
-    auto row = table->AddTableRow();
-    row->SetAttribute("title", title);
+    const std::string& name = category.ToString();
+    html.Open("tr");
+    html.Attribute("title", title);
     if (title != "sum")
     {
-        row->SetAttribute("style", "display: none;");
+        html.Attribute("style", "display: none;");
     }
 
-    for (int year = minYear; year <= maxYear; ++year)
+    for (int year = summary.GetMinYear(); year <= summary.GetMaxYear(); ++year)
     {
-        auto cell = row->AddTableCell();
-        cell->SetAttribute("class", "name");
-        cell->AddText(category.empty() ? "*" : category);
+        html.Open("td");
+        html.Attribute("class", "name");
+        html.Text(name.empty() ? "*" : name);
+        html.Close();
 
         for (int month = 1; month <= 12; ++month)
         {
-            AddSummaryCell(row, rowCount, category, month, year, sortedTables, filter);
+            AddSummaryCell(html, rowCount, summary, category, month, year, filter);
         }
 
-        AddSummaryCell(row, rowCount, category, 0, year, sortedTables, filter);
+        AddSummaryCell(html, rowCount, summary, category, 0, year, filter);
     }
 
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "name");
-    cell->AddText(category.empty() ? "*" : category);
+    html.Open("td");
+    html.Attribute("class", "name");
+    html.Text(name.empty() ? "*" : name);
+    html.Close();
+    html.Close();
 }
 
 std::string HtmlGenerator::GetSummaryPage(const CsvDatabase& database)
 {
-    HtmlElement html;
-    AddHtmlHead(&html);
-
-    auto body = html.AddBody();
-    body->AddScript("filterSummary.js");
-    body->SetAttribute("onload", "scrollSummary();");
-    auto box = AddNavigationHeader(body, database);
-
-    auto table = box->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form fill");
-    cell->AddDivision("&nbsp;");
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    auto div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    div->AddImage("48-sign-add.png", "Show Profit", 40);
-    div->SetAttribute("onclick", "filterSummary('summary', 'profit')");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    div->AddImage("48-sign-b.png", "Show Sum", 40);
-    div->SetAttribute("onclick", "filterSummary('summary', 'sum')");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    div->AddImage("48-sign-delete.png", "Show Expenses", 40);
-    div->SetAttribute("onclick", "filterSummary('summary', 'expenses')");
-
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
-    main->AddHeading(2, "Summary");
-
+    HtmlWriter html;
+    AddHtmlHead(html);
+
+    html.Open("body");
+    html.Attribute("onload", "scrollSummary();");
+    html.Script("filterSummary.js");
+    OpenNavigationHeader(html, database);
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form fill");
+    html.Element("div", "&nbsp;");
+    html.Close();
+    html.Element("td", {}, {{"class", "form"}});
+
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Open("div");
+    html.Attribute("class", "box");
+    html.Attribute("onclick", "filterSummary('summary', 'profit')");
+    html.Image("48-sign-add.png", "Show Profit", 40);
+    html.Close();
+    html.Close();
+
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Open("div");
+    html.Attribute("class", "box");
+    html.Attribute("onclick", "filterSummary('summary', 'sum')");
+    html.Image("48-sign-b.png", "Show Sum", 40);
+    html.Close();
+    html.Close();
+
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Open("div");
+    html.Attribute("class", "box");
+    html.Attribute("onclick", "filterSummary('summary', 'expenses')");
+    html.Image("48-sign-delete.png", "Show Expenses", 40);
+    html.Close();
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
+    CloseNavigationHeader(html);
+
+    html.Open("main");
+    html.Attribute("class", "pad-100");
+    html.Element("h2", "Summary");
     // Determine (used) Categories
-    std::vector<std::string> categories = database.GetCategories();
-    categories.insert(categories.begin(), "");
-
-    // Sort data
-    int minYear = 3000;
-    int maxYear = 1900;
-    std::map<int, std::map<int, std::map<std::string, CsvTable>>> sortedTables;
-    for (auto& item : database.Data)
-    {
-        const int year = item->Date.GetYear();
-        const int month = item->Date.GetMonth();
-        sortedTables[year][0][categories[0]].push_back(item);
-        sortedTables[year][0][item->Category].push_back(item);
-        sortedTables[year][month][categories[0]].push_back(item);
-        sortedTables[year][month][item->Category].push_back(item);
-
-        if (minYear > year)
-        {
-            minYear = year;
-        }
-        if (maxYear < year)
-        {
-            maxYear = year;
-        }
-    }
+    std::vector<CsvSymbol> categories = database.GetCategories();
+    categories.insert(categories.begin(), CsvSymbol());
+
+    // Sums are kept up to date by the database, so the page does not depend on the number of items
+    const CsvSummary& summary = database.GetSummary();
 
-    div = main->AddDivision();
-    div->SetAttribute("class", "tab");
+    html.Open("div");
+    html.Attribute("class", "tab");
 
-    table = div->AddTable();
-    table->SetAttribute("id", "summary");
-    table->SetAttribute("class", "item mar-20");
+    html.Open("table");
+    html.Attribute("id", "summary");
+    html.Attribute("class", "item mar-20");
 
     int rowCount = 0;
-    AddSummaryTableHeader(table, minYear, maxYear);
+    AddSummaryTableHeader(html, summary.GetMinYear(), summary.GetMaxYear());
     for (auto& category : categories)
     {
         rowCount++;
-        AddSummaryRow(table, rowCount, minYear, maxYear, category, sortedTables, 0, "sum");
-        AddSummaryRow(table, rowCount, minYear, maxYear, category, sortedTables, +1, "profit");
-        AddSummaryRow(table, rowCount, minYear, maxYear, category, sortedTables, -1, "expenses");
+        AddSummaryRow(html, rowCount, summary, category, 0, "sum");
+        AddSummaryRow(html, rowCount, summary, category, +1, "profit");
+        AddSummaryRow(html, rowCount, summary, category, -1, "expenses");
     }
 
-    return html.ToString();
+    return html.Finish();
 }
 
-std::string HtmlGenerator::GetTablePage(const CsvDatabase& database, std::string title, const CsvTable& data,
-                                        int filter)
+void HtmlGenerator::AddPageNavigation(HtmlWriter& html, const HtmlTableWindow& window, size_t rowCount)
+{
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form fill");
+    html.Element("div", "&nbsp;");
+    html.Close();
+
+    std::string link{};
+    if (window.Offset > 0)
+    {
+        link = GetWindowLink(window.PageLink, window.Offset - std::min(window.Offset, window.Limit), window.Limit);
+    }
+    AddNavigationCell(html, link, "Previous Rows", "48-sign-left-y.png", "No Previous Rows", "48-sign-left-g.png");
+
+    const size_t end = window.GetEnd(rowCount);
+    const size_t first = std::min(window.GetBegin(rowCount) + 1, end);
+    html.Element("td", fmt::format("{}&nbsp;-&nbsp;{}&nbsp;/&nbsp;{}", first, end, rowCount),
+                 {{"class", "form mono center"}});
+
+    link.clear();
+    if (end < rowCount)
+    {
+        link = GetWindowLink(window.PageLink, end, window.Limit);
+    }
+    AddNavigationCell(html, link, "Next Rows", "48-sign-right-y.png", "No Next Rows", "48-sign-right-g.png");
+    html.Close(); // tr
+    html.Close(); // table
+}
+
+void HtmlGenerator::BeginTablePage(HtmlWriter& html, const CsvDatabase& database, std::string title, int filter,
+                                   size_t rowCount, const HtmlTableWindow& window)
 {
     if (filter < 0)
     {
@@ -359,401 +441,519 @@ std::string HtmlGenerator::GetTablePage(const CsvDatabase& database, std::string
         title += " (+)";
     }
 
-    HtmlElement html;
-    AddHtmlHead(&html);
-
-    auto body = html.AddBody();
-    AddNavigationHeader(body, database);
-
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
-
-    auto table = main->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-    cell->SetAttribute("style", "width: 50%;");
-    cell->AddHeading(2, title);
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-    auto input = cell->AddInput();
-    input->SetAttribute("id", "filter");
-    input->SetAttribute("type", "text");
-    input->SetAttribute("placeholder", "Filter...");
-    input->SetAttribute("title", "Type in a string");
-    input->SetAttribute("oninput", "filterTable('table', 'filter')");
-    input->SetAttribute("class", "filter");
-
-    table = main->AddTable();
-    table->SetAttribute("id", "table");
-    table->SetAttribute("class", "item mar-20");
-    AddItemTableHeader(table);
-    for (const auto& r : data)
+    AddHtmlHead(html);
+
+    html.Open("body");
+    OpenNavigationHeader(html, database);
+    if (window.Limit > 0)
+    {
+        AddPageNavigation(html, window, rowCount);
+    }
+    CloseNavigationHeader(html);
+
+    html.Open("main");
+    html.Attribute("class", "pad-100");
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form");
+    html.Attribute("style", "width: 50%;");
+    html.Element("h2", title);
+    html.Close();
+    html.Open("td");
+    html.Attribute("class", "form");
+    html.Open("input");
+    html.Attribute("id", "filter");
+    html.Attribute("type", "text");
+    html.Attribute("placeholder", "Filter...");
+    html.Attribute("title", "Type in a string, press enter to search all rows");
+    if (!window.Search.empty())
+    {
+        html.Attribute("value", Utils::EscapeHtml(window.Search));
+    }
+    html.Attribute("oninput", "filterTable('table', 'filter')");
+    html.Attribute("onkeydown", "if (event.key == 'Enter') { searchTable('filter'); }");
+    html.Attribute("class", "filter");
+    html.Close();
+    html.Close();
+    html.Close();
+    html.Close();
+
+    html.Open("table");
+    html.Attribute("id", "table");
+    html.Attribute("class", "item mar-20");
+    if (window.Limit > 0 && !window.RowsLink.empty())
+    {
+        // Read by scrollTable.js to append the following rows
+        html.Attribute("data-rows", window.RowsLink);
+        html.Attribute("data-offset", std::to_string(window.GetEnd(rowCount)));
+        html.Attribute("data-limit", std::to_string(window.Limit));
+        html.Attribute("data-count", std::to_string(rowCount));
+    }
+    AddItemTableHeader(html);
+}
+
+void HtmlGenerator::AddTableRows(HtmlWriter& html, const std::vector<CsvRowShared>& rows, size_t begin,
+                                 size_t end)
+{
+    for (size_t i = begin; i < std::min(end, rows.size()); ++i)
     {
-        AddItemTableRow(table, r.get());
+        AddItemTableRow(html, rows[i].get());
     }
-    body->AddScript("filterTable.js");
+}
 
-    return html.ToString();
+void HtmlGenerator::EndTablePage(HtmlWriter& html, const HtmlTableWindow& window)
+{
+    html.Close(); // table
+    html.Close(); // main
+    html.Script("filterTable.js");
+    if (window.Limit > 0 && !window.RowsLink.empty())
+    {
+        html.Script("scrollTable.js");
+    }
+}
+
+std::string HtmlGenerator::GetTablePage(const CsvDatabase& database, std::string title, const CsvTable& data,
+                                        int filter, const HtmlTableWindow& window)
+{
+    HtmlWriter html;
+    BeginTablePage(html, database, std::move(title), filter, data.size(), window);
+    AddTableRows(html, data.GetRows(), window.GetBegin(data.size()), window.GetEnd(data.size()));
+    EndTablePage(html, window);
+    return html.Finish();
+}
+
+std::string HtmlGenerator::GetTableRows(const std::vector<CsvRowShared>& rows, size_t offset, size_t limit)
+{
+    const size_t begin = std::min(offset, rows.size());
+    const size_t end = begin + std::min(limit, rows.size() - begin);
+    std::string json = fmt::format("{{\"count\":{},\"offset\":{},\"rows\":[", rows.size(), offset);
+    for (size_t i = offset; i < end; ++i)
+    {
+        const CsvItem* row = rows[i].get();
+        json += fmt::format("{}{{\"id\":{},\"class\":\"{}\",\"cells\":[\"{}\",\"{}\",\"{}\",\"{}\",\"{}\",\"{}\","
+                            "\"{}\"],\"valueClass\":\"{}\"}}",
+                            i == offset ? "" : ",", row->Id, GetRowStyle(row),
+                            Utils::EscapeJson(row->GetCategory().ToString()), Utils::EscapeJson(row->GetPayerPayee()),
+                            Utils::EscapeJson(row->GetDescription()), Utils::EscapeJson(row->GetType().ToString()),
+                            row->GetDate().ToString(), Utils::EscapeJson(row->GetAccount().ToString()),
+                            row->GetValue().ToString(), GetValueStyle(row));
+    }
+    json += "]}";
+    return json;
 }
 
 std::string HtmlGenerator::GetErrorPage(int errorCode, const std::string& errorMessage)
 {
     Utils::PrintError(fmt::format("HttpServer operation failed: {}", errorMessage));
 
-    HtmlElement html;
-    AddHtmlHead(&html);
+    HtmlWriter html;
+    AddHtmlHead(html);
 
-    auto body = html.AddBody();
-    auto main = body->AddMain();
-    main->SetAttribute("class", "mar-50");
+    html.Open("body");
+    html.Open("main");
+    html.Attribute("class", "mar-50");
 
-    auto div = main->AddDivision();
-    div->SetAttribute("class", "msg box red");
+    html.Open("div");
+    html.Attribute("class", "msg box red");
 
-    auto p = div->AddDivision();
-    p->AddHyperlinkImage(EXIT_CMD, "Stop hokee", "96-sign-ban.png", 96);
+    html.Open("div");
+    html.HyperlinkImage(EXIT_CMD, "Stop hokee", "96-sign-ban.png", 96);
+    html.Close();
 
-    div->AddHeading(2, fmt::format("ERROR {}", errorCode));
-    div->AddParagraph()->AddBold(errorMessage);
+    html.Element("h2", fmt::format("ERROR {}", errorCode));
+    html.Open("p");
+    html.Element("b", errorMessage);
+    html.Close();
 
-    div->AddParagraph("&nbsp;");
-    div->AddParagraph("&nbsp;");
-    div->AddParagraph("What next?");
+    html.Element("p", "&nbsp;");
+    html.Element("p", "&nbsp;");
+    html.Element("p", "What next?");
 
-    auto table = div->AddDivision()->AddTable();
-    table->SetAttribute("class", "nav");
+    html.Open("div");
+    html.Open("table");
+    html.Attribute("class", "nav");
 
-    auto row = table->AddTableRow();
+    html.Open("tr");
 
-    auto cell = row->AddTableCell("&nbsp;");
-    cell->SetAttribute("class", "nav fill");
+    html.Element("td", "&nbsp;", {{"class", "nav fill"}});
 
-    AddButton(row, BACKUP_HTML, "Open Rule Backup", "48-safe.png", "Rule Backups");
-    AddButton(row, INPUT_CMD, "Open Input Folder", "48-folder.png", "Input Folder");
-    AddButton(row, SUPPORT_HTML, "Generate Support Mail", "48-envelope-letter.png", "Get&nbsp;Support");
-    AddButton(row, SETTINGS_HTML, "Open Settings File", "48-cogs.png", "Settings");
-    AddButton(row, RELOAD_CMD, "Reload CSV Data", "48-sign-sync.png", "Reload");
-    AddButton(row, EXIT_CMD, "Stop hokee", "48-sign-exit.png", "Exit");
+    AddButton(html, BACKUP_HTML, "Open Rule Backup", "48-safe.png", "Rule Backups");
+    AddButton(html, INPUT_CMD, "Open Input Folder", "48-folder.png", "Input Folder");
+    AddButton(html, SUPPORT_HTML, "Generate Support Mail", "48-envelope-letter.png", "Get&nbsp;Support");
+    AddButton(html, SETTINGS_HTML, "Open Settings File", "48-cogs.png", "Settings");
+    AddButton(html, RELOAD_CMD, "Reload CSV Data", "48-sign-sync.png", "Reload");
+    AddButton(html, EXIT_CMD, "Stop hokee", "48-sign-exit.png", "Exit");
 
-    cell = row->AddTableCell("&nbsp;");
-    cell->SetAttribute("class", "nav fill");
+    html.Element("td", "&nbsp;", {{"class", "nav fill"}});
 
-    return html.ToString();
+    return html.Finish();
 }
 
 std::string HtmlGenerator::GetBackupPage(const CsvDatabase& database, const fs::path& ruleSetFile)
 {
-    HtmlElement html;
-    AddHtmlHead(&html);
+    HtmlWriter html;
+    AddHtmlHead(html);
 
-    auto body = html.AddBody();
-    AddNavigationHeader(body, database);
+    html.Open("body");
+    OpenNavigationHeader(html, database);
+    CloseNavigationHeader(html);
 
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
+    html.Open("main");
+    html.Attribute("class", "pad-100");
 
-    main->AddHeading(2, "Backup Rules");
+    html.Element("h2", "Backup Rules");
 
-    auto table = main->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
 
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    cell->AddImage("48-sign-add.png", "Add new rule", 38);
-    cell->SetAttribute("onclick", fmt::format("window.location='{}';", BACKUP_CMD));
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Attribute("onclick", fmt::format("window.location='{}';", BACKUP_CMD));
+    html.Image("48-sign-add.png", "Add new rule", 38);
+    html.Close();
 
-    cell = row->AddTableCell(ruleSetFile.string());
-    cell->SetAttribute("class", "form fill center mono");
+    html.Element("td", ruleSetFile.string(), {{"class", "form fill center mono"}});
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form");
     std::string link = fmt::format("{}?file={}", HtmlGenerator::EDIT_HTML, ruleSetFile.string());
-    cell->AddHyperlinkImage(link, "Edit Settings File", "48-notepad.png", 38);
+    html.HyperlinkImage(link, "Edit Settings File", "48-notepad.png", 38);
+    html.Close();
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form");
     link = fmt::format("{}?folder={}", HtmlGenerator::OPEN_CMD, ruleSetFile.parent_path().string());
-    cell->AddHyperlinkImage(link, "Open folder", "48-folder.png", 38);
-
-    main->AddHeading(3, "Backup Files");
-    table = main->AddTable();
-    table->SetAttribute("class", "item mar-20");
+    html.HyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
+
+    html.Element("h3", "Backup Files");
+    html.Open("table");
+    html.Attribute("class", "item mar-20");
+    size_t backupCount = 0;
     for (const auto& entry : fs::directory_iterator(ruleSetFile.parent_path()))
     {
         std::string filename = entry.path().filename().string();
 
         if (filename.find(ruleSetFile.filename().string() + ".") != std::string::npos)
         {
-            row = table->AddTableRow();
-            cell = row->AddTableCell();
-            cell->SetAttribute("class", "item link");
-            cell->AddImage("48-sign-delete.png", "Add new rule", 38);
-            cell->SetAttribute("onclick",
-                               fmt::format("deleteBackup('{}?file={}', '{}')", DELETE_CMD, filename, filename));
-            body->AddScript("deleteBackup.js");
-
-            cell = row->AddTableCell(filename);
-            cell->SetAttribute("class", "item center mono link fill");
-            cell->SetAttribute("onclick",
-                               fmt::format("restoreBackup('{}?file={}', '{}')", RESTORE_CMD, filename, filename));
-            body->AddScript("restoreBackup.js");
-
-            cell = row->AddTableCell();
-            cell->SetAttribute("class", "item link");
+            ++backupCount;
+            html.Open("tr");
+            html.Open("td");
+            html.Attribute("class", "item link");
+            html.Attribute("onclick",
+                           fmt::format("deleteBackup('{}?file={}', '{}')", DELETE_CMD, filename, filename));
+            html.Image("48-sign-delete.png", "Add new rule", 38);
+            html.Close();
+
+            html.Element("td", filename,
+                         {{"class", "item center mono link fill"},
+                          {"onclick", fmt::format("restoreBackup('{}?file={}', '{}')", RESTORE_CMD, filename,
+                                                  filename)}});
+
+            html.Open("td");
+            html.Attribute("class", "item link");
             link = fmt::format("{}?file={}", HtmlGenerator::EDIT_HTML, entry.path().string());
-            cell->AddHyperlinkImage(link, "Edit Settings File", "48-notepad.png", 38);
+            html.HyperlinkImage(link, "Edit Settings File", "48-notepad.png", 38);
+            html.Close();
 
-            cell = row->AddTableCell();
-            cell->SetAttribute("class", "item link");
+            html.Open("td");
+            html.Attribute("class", "item link");
             link = fmt::format("{}?folder={}", HtmlGenerator::OPEN_CMD, entry.path().parent_path().string());
-            cell->AddHyperlinkImage(link, "Open folder", "48-folder.png", 38);
+            html.HyperlinkImage(link, "Open folder", "48-folder.png", 38);
+            html.Close();
+            html.Close(); // tr
         }
     }
+    html.Close(); // table
+    html.Close(); // main
+
+    for (size_t i = 0; i < backupCount; ++i)
+    {
+        html.Script("deleteBackup.js");
+        html.Script("restoreBackup.js");
+    }
 
-    return html.ToString();
+    return html.Finish();
 }
 
 std::string HtmlGenerator::GetSupportPage(const CsvDatabase& database, const fs::path& ruleSetFile,
                                           const fs::path& inputDir)
 {
-    HtmlElement html;
-    AddHtmlHead(&html);
-
-    auto body = html.AddBody();
-    auto box = AddNavigationHeader(body, database);
-
-    auto table = box->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-    cell->AddDivision("&nbsp;");
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form fill");
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    auto div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    div->AddImage("48-envelope-letter.png", "Submit", 40);
-    div->SetAttribute("onclick", "submitMail('form')");
-    body->AddScript("submitMail.js");
-
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
-    main->AddHeading(2, "Generate&nbsp;Support&nbsp;Mail");
-
-    auto form = main->AddForm();
-    form->SetAttribute("action", "mailto:schedler@paderborn.com");
-    form->SetAttribute("method", "post");
-    form->SetAttribute("enctype", "text/plain");
-    form->SetAttribute("id", "form");
+    HtmlWriter html;
+    AddHtmlHead(html);
+
+    html.Open("body");
+    OpenNavigationHeader(html, database);
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form");
+    html.Element("div", "&nbsp;");
+    html.Close();
+    html.Element("td", {}, {{"class", "form fill"}});
+    html.Element("td", {}, {{"class", "form"}});
+
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Open("div");
+    html.Attribute("class", "box");
+    html.Attribute("onclick", "submitMail('form')");
+    html.Image("48-envelope-letter.png", "Submit", 40);
+    html.Close();
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
+    CloseNavigationHeader(html);
+    html.Script("submitMail.js");
+
+    html.Open("main");
+    html.Attribute("class", "pad-100");
+    html.Element("h2", "Generate&nbsp;Support&nbsp;Mail");
+
+    html.Open("form");
+    html.Attribute("action", "mailto:schedler@paderborn.com");
+    html.Attribute("method", "post");
+    html.Attribute("enctype", "text/plain");
+    html.Attribute("id", "form");
     std::string mail = Utils::GenerateSupportMail(ruleSetFile, inputDir);
-    auto label = form->AddLabel("Fill the section below and send it to schedler@paderborn.com");
-    label->SetAttribute("class", "mar-20");
-    auto textarea = label->AddTextarea(Utils::EscapeHtml(mail));
-    textarea->SetAttribute("name", "body");
-    textarea->SetAttribute("rows", "20");
+    html.Open("label", true);
+    html.Attribute("class", "mar-20");
+    html.Text("Fill the section below and send it to schedler@paderborn.com");
+    html.Open("textarea", !mail.empty());
+    html.Attribute("name", "body");
+    html.Attribute("rows", "20");
+    if (!mail.empty())
+    {
+        html.EscapedText(mail);
+    }
 
-    return html.ToString();
+    return html.Finish();
 }
 
 std::string HtmlGenerator::GetEditPage(const CsvDatabase& database, const fs::path& file, bool saved)
 {
-    HtmlElement html;
-    AddHtmlHead(&html);
+    HtmlWriter html;
+    AddHtmlHead(html);
 
-    auto body = html.AddBody();
+    html.Open("body");
     if (saved)
     {
-        body->SetAttribute("class", "blink-success");
+        html.Attribute("class", "blink-success");
     }
-    AddNavigationHeader(body, database);
+    OpenNavigationHeader(html, database);
+    CloseNavigationHeader(html);
 
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
+    html.Open("main");
+    html.Attribute("class", "pad-100");
 
-    auto form = main->AddForm();
+    html.Open("form");
     std::string filename = file.string();
-    form->SetAttribute("action", fmt::format("{}?file={}", HtmlGenerator::SAVE_CMD, filename));
-    form->SetAttribute("method", "post");
-    form->SetAttribute("enctype", "text/plain");
-    form->SetAttribute("id", "form");
-
-    auto table = form->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form fill");
-    cell->AddHeading(2, "Edit&nbsp;File");
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-
-    cell = row->AddTableCell();
-    cell->AddImage("48-floppy.png", "Save File", 40);
-    cell->SetAttribute("class", "form link");
-    cell->SetAttribute("onclick", "submitFile('form')");
-    body->AddScript("submitFile.js");
-
-    table = form->AddTable();
-    table->SetAttribute("class", "form");
-    row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    cell = row->AddTableCell(file.string());
-    cell->SetAttribute("class", "form fill mono center");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
+    html.Attribute("action", fmt::format("{}?file={}", HtmlGenerator::SAVE_CMD, filename));
+    html.Attribute("method", "post");
+    html.Attribute("enctype", "text/plain");
+    html.Attribute("id", "form");
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form fill");
+    html.Element("h2", "Edit&nbsp;File");
+    html.Close();
+    html.Element("td", {}, {{"class", "form"}});
+
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Attribute("onclick", "submitFile('form')");
+    html.Image("48-floppy.png", "Save File", 40);
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Element("td", file.string(), {{"class", "form fill mono center"}});
+
+    html.Open("td");
+    html.Attribute("class", "form");
     std::string link = fmt::format("{}?folder={}", HtmlGenerator::OPEN_CMD, file.parent_path().string());
-    cell->AddHyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.HyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
 
-    table = form->AddTable();
-    table->SetAttribute("class", "form");
-    row = table->AddTableRow();
-    row->SetAttribute("class", "form");
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Element("tr", {}, {{"class", "form"}});
+    html.Close();
 
     std::string content = Utils::ReadFileContent(file);
-    auto label = form->AddLabel("&nbsp;");
-    auto textarea = label->AddTextarea(Utils::EscapeHtml(content));
-    textarea->SetAttribute("name", "content");
-    textarea->SetAttribute("rows", "20");
+    html.Open("label", true);
+    html.Text("&nbsp;");
+    html.Open("textarea", !content.empty());
+    html.Attribute("name", "content");
+    html.Attribute("rows", "20");
+    if (!content.empty())
+    {
+        html.EscapedText(content);
+    }
+    html.Close(); // textarea
+    html.Close(); // label
+    html.Close(); // form
+    html.Close(); // main
+    html.Script("submitFile.js");
 
-    return html.ToString();
+    return html.Finish();
 }
 
-void HtmlGenerator::AddInputForm(HtmlElement* table, const std::string& name, const std::string& value,
+void HtmlGenerator::AddInputForm(HtmlWriter& html, const std::string& name, const std::string& value,
                                  const std::string& description)
 {
-    auto row = table->AddTableRow();
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form fill");
-    auto label = cell->AddLabel(description);
-    label->SetAttribute("class", "marb-20");
-    auto input = label->AddInput();
-    input->SetAttribute("class", "form");
-    input->SetAttribute("type", "text");
-    input->SetAttribute("name", name);
-    input->SetAttribute("value", value);
+    html.Open("tr");
+    html.Open("td");
+    html.Attribute("class", "form fill");
+    html.Open("label", !description.empty());
+    html.Attribute("class", "marb-20");
+    html.Text(description);
+    html.Element("input", {}, {{"class", "form"}, {"type", "text"}, {"name", name}, {"value", value}});
+    html.Close();
+    html.Close();
+    html.Close();
 }
 
 std::string HtmlGenerator::GetSettingsPage(const CsvDatabase& database, const fs::path& file, bool saved)
 {
-    HtmlElement html;
-    AddHtmlHead(&html);
+    HtmlWriter html;
+    AddHtmlHead(html);
 
-    auto body = html.AddBody();
+    html.Open("body");
     if (saved)
     {
-        body->SetAttribute("class", "blink-success");
+        html.Attribute("class", "blink-success");
     }
-    auto box = AddNavigationHeader(body, database);
-
-    auto table = box->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form fill");
-    cell->AddDivision("&nbsp;");
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    auto div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    div->AddImage("48-floppy.png", "Save Settings", 40);
-    div->SetAttribute("onclick", "submitSettings('form')");
-    body->AddScript("submitSettings.js");
-
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
-    main->AddHeading(2, "Settings");
-
-    auto form = main->AddForm();
-    form->SetAttribute("action", HtmlGenerator::SETTINGS_HTML);
-    form->SetAttribute("method", "get");
-    form->SetAttribute("enctype", "text/plain");
-    form->SetAttribute("id", "form");
-
-    table = form->AddTable();
-    table->SetAttribute("class", "form");
-    row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    cell = row->AddTableCell(file.string());
-    cell->SetAttribute("class", "form fill center mono");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
+    OpenNavigationHeader(html, database);
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form fill");
+    html.Element("div", "&nbsp;");
+    html.Close();
+    html.Element("td", {}, {{"class", "form"}});
+
+    html.Open("td");
+    html.Attribute("class", "form link");
+    html.Open("div");
+    html.Attribute("class", "box");
+    html.Attribute("onclick", "submitSettings('form')");
+    html.Image("48-floppy.png", "Save Settings", 40);
+    html.Close();
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
+    CloseNavigationHeader(html);
+    html.Script("submitSettings.js");
+
+    html.Open("main");
+    html.Attribute("class", "pad-100");
+    html.Element("h2", "Settings");
+
+    html.Open("form");
+    html.Attribute("action", HtmlGenerator::SETTINGS_HTML);
+    html.Attribute("method", "get");
+    html.Attribute("enctype", "text/plain");
+    html.Attribute("id", "form");
+
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Element("td", file.string(), {{"class", "form fill center mono"}});
+
+    html.Open("td");
+    html.Attribute("class", "form");
     std::string link = fmt::format("{}?file={}", HtmlGenerator::EDIT_HTML, file.string());
-    cell->AddHyperlinkImage(link, "Edit Settings File", "48-notepad.png", 38);
+    html.HyperlinkImage(link, "Edit Settings File", "48-notepad.png", 38);
+    html.Close();
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
+    html.Open("td");
+    html.Attribute("class", "form");
     link = fmt::format("{}?folder={}", HtmlGenerator::OPEN_CMD, file.parent_path().string());
-    cell->AddHyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.HyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
 
-    table = form->AddTable();
-    table->SetAttribute("class", "form");
+    html.Open("table");
+    html.Attribute("class", "form");
 
     Settings config(file);
-    AddInputForm(table, "InputDirectory", config.GetInputDirectory().string(), "Input directory*:");
-    AddInputForm(table, "RuleSetFile", config.GetRuleSetFile().string(), "Rule definition file*:");
-    AddInputForm(table, "Browser", config.GetBrowser(), "Webbrowser start command:");
-    AddInputForm(table, "Explorer", config.GetExplorer(), "Fileexplorer start command:");
-    AddInputForm(table, "Port", std::to_string(config.GetServerPort()), "Http-Server port (0 == dynamic):");
+    AddInputForm(html, "InputDirectory", config.GetInputDirectory().string(), "Input directory*:");
+    AddInputForm(html, "RuleSetFile", config.GetRuleSetFile().string(), "Rule definition file*:");
+    AddInputForm(html, "Browser", config.GetBrowser(), "Webbrowser start command:");
+    AddInputForm(html, "Explorer", config.GetExplorer(), "Fileexplorer start command:");
+    AddInputForm(html, "Port", std::to_string(config.GetServerPort()), "Http-Server port (0 == dynamic):");
+    html.Close(); // table
+    html.Close(); // form
 
-    main->AddParagraph(fmt::format("*Paths can be absolute or relative to \"{}\"", file.parent_path().string()));
+    html.Element("p", fmt::format("*Paths can be absolute or relative to \"{}\"", file.parent_path().string()));
 
-    return html.ToString();
+    return html.Finish();
 }
 
 std::string HtmlGenerator::GetEmptyInputPage()
 {
-    HtmlElement html;
-    AddHtmlHead(&html);
+    HtmlWriter html;
+    AddHtmlHead(html);
 
-    auto body = html.AddBody();
-    auto main = body->AddMain();
-    main->SetAttribute("class", "mar-50");
+    html.Open("body");
+    html.Open("main");
+    html.Attribute("class", "mar-50");
 
-    auto div = main->AddDivision();
-    div->SetAttribute("class", "msg box");
+    html.Open("div");
+    html.Attribute("class", "msg box");
 
-    auto p = div->AddParagraph();
-    p->AddHyperlinkImage(INPUT_CMD, "Open Input Folder", "96-box.png", 96);
+    html.Open("p");
+    html.HyperlinkImage(INPUT_CMD, "Open Input Folder", "96-box.png", 96);
+    html.Close();
 
-    div->AddHeading(2, "Could not find any input data!");
+    html.Element("h2", "Could not find any input data!");
 
-    div->AddParagraph("&nbsp;");
-    div->AddParagraph("&nbsp;");
-    div->AddParagraph("What next?");
-    auto table = div->AddDivision()->AddTable();
-    table->SetAttribute("class", "nav");
+    html.Element("p", "&nbsp;");
+    html.Element("p", "&nbsp;");
+    html.Element("p", "What next?");
+    html.Open("div");
+    html.Open("table");
+    html.Attribute("class", "nav");
 
-    auto row = table->AddTableRow();
+    html.Open("tr");
 
-    auto cell = row->AddTableCell("&nbsp;");
-    cell->SetAttribute("class", "nav fill");
+    html.Element("td", "&nbsp;", {{"class", "nav fill"}});
 
-    AddButton(row, COPY_SAMPLES_CMD, "Copy Samples", "48-box-in.png", "Copy&nbsp;Samples");
-    AddButton(row, SETTINGS_HTML, "Open Settings", "48-cogs.png", "Open&nbsp;Settings");
-    AddButton(row, RELOAD_CMD, "Reload CSV Data", "48-sign-sync.png", "Reload");
-    AddButton(row, EXIT_CMD, "Stop hokee", "48-sign-exit.png", "Exit");
+    AddButton(html, COPY_SAMPLES_CMD, "Copy Samples", "48-box-in.png", "Copy&nbsp;Samples");
+    AddButton(html, SETTINGS_HTML, "Open Settings", "48-cogs.png", "Open&nbsp;Settings");
+    AddButton(html, RELOAD_CMD, "Reload CSV Data", "48-sign-sync.png", "Reload");
+    AddButton(html, EXIT_CMD, "Stop hokee", "48-sign-exit.png", "Exit");
 
-    cell = row->AddTableCell("&nbsp;");
-    cell->SetAttribute("class", "nav fill");
+    html.Element("td", "&nbsp;", {{"class", "nav fill"}});
 
-    return html.ToString();
+    return html.Finish();
 }
 
 std::string HtmlGenerator::GetProgressPage(size_t value, size_t max)
@@ -768,57 +968,67 @@ std::string HtmlGenerator::GetProgressPage(size_t value, size_t max)
     const std::string m6 = lastMessages.size() > 6 ? lastMessages[6] : "";
     const std::string m7 = lastMessages.size() > 7 ? lastMessages[7] : "";
 
-    HtmlElement html;
-    auto head = AddHtmlHead(&html);
-    auto meta = head->AddMeta();
-    meta->SetAttribute("http-equiv", "refresh");
-    meta->SetAttribute("content", "0.5");
-
-    auto body = html.AddBody();
-    auto main = body->AddMain();
-    main->SetAttribute("class", "mar-50");
-
-    auto div = main->AddDivision();
-    div->SetAttribute("class", "msg box");
-    div->AddParagraph("&nbsp;");
-    div->AddDivision(m7)->SetAttribute("style", "opacity:0.1;");
-    div->AddDivision(m6)->SetAttribute("style", "opacity:0.2;");
-    div->AddDivision(m5)->SetAttribute("style", "opacity:0.3;");
-    div->AddDivision(m4)->SetAttribute("style", "opacity:0.4;");
-    div->AddDivision(m3)->SetAttribute("style", "opacity:0.6;");
-    div->AddDivision(m2)->SetAttribute("style", "opacity:0.8;");
-    div->AddDivision(m1)->SetAttribute("style", "opacity:1;");
-    div->AddParagraph("&nbsp;");
-    div->AddDivision()->AddProgress(value, max);
-    return html.ToString();
+    HtmlWriter html;
+    AddHtmlHead(html, true);
+
+    html.Open("body");
+    html.Open("main");
+    html.Attribute("class", "mar-50");
+
+    html.Open("div");
+    html.Attribute("class", "msg box");
+    html.Element("p", "&nbsp;");
+    html.Element("div", m7, {{"style", "opacity:0.1;"}});
+    html.Element("div", m6, {{"style", "opacity:0.2;"}});
+    html.Element("div", m5, {{"style", "opacity:0.3;"}});
+    html.Element("div", m4, {{"style", "opacity:0.4;"}});
+    html.Element("div", m3, {{"style", "opacity:0.6;"}});
+    html.Element("div", m2, {{"style", "opacity:0.8;"}});
+    html.Element("div", m1, {{"style", "opacity:1;"}});
+    html.Element("p", "&nbsp;");
+    html.Open("div");
+    html.Progress(value, max);
+    return html.Finish();
+}
+
+namespace
+{
+void AddRuleInput(HtmlWriter& html, const std::string& width, const std::string& labelText,
+                  const std::string& labelClass, const std::string& name, const std::string& placeholder,
+                  std::string_view value)
+{
+    html.Open("td");
+    html.Attribute("class", "form");
+    html.Attribute("style", width);
+    html.Open("label", true);
+    html.Attribute("class", labelClass);
+    html.Text(labelText);
+    html.Element("input", {},
+                 {{"name", name},
+                  {"id", name},
+                  {"type", "text"},
+                  {"class", "form mono"},
+                  {"placeholder", placeholder},
+                  {"value", value}});
+    html.Close();
+    html.Close();
 }
+} // namespace
 
 std::string HtmlGenerator::GetItemPage(const CsvDatabase& database, int id, int flag)
 {
     std::string title = "";
     bool isItem = false;
-    std::shared_ptr<CsvItem> item = nullptr;
-    for (auto& i : database.Data)
+    std::shared_ptr<CsvItem> item = database.Data.FindItem(id);
+    if (item)
     {
-        if (i->Id == id)
-        {
-            item = i;
-            title = fmt::format("Item&nbsp;{}", id);
-            isItem = true;
-            break;
-        }
+        title = fmt::format("Item&nbsp;{}", id);
+        isItem = true;
     }
-    if (!item)
+    else
     {
-        for (auto& r : database.Rules)
-        {
-            if (r->Id == id)
-            {
-                item = r;
-                title = fmt::format("Rule&nbsp;{}", id);
-                break;
-            }
-        }
+        item = database.Rules.FindItem(id);
+        title = fmt::format("Rule&nbsp;{}", id);
 
         if (!item)
         {
@@ -826,410 +1036,302 @@ std::string HtmlGenerator::GetItemPage(const CsvDatabase& database, int id, int
         }
     }
 
-    HtmlElement html;
-    AddHtmlHead(&html);
+    HtmlWriter html;
+    AddHtmlHead(html);
 
-    auto body = html.AddBody();
+    html.Open("body");
     if (flag > 0)
     {
-        body->SetAttribute("class", "blink-success");
+        html.Attribute("class", "blink-success");
     }
     else if (flag < 0)
     {
-        body->SetAttribute("class", "blink-failed");
+        html.Attribute("class", "blink-failed");
     }
-    auto box = AddNavigationHeader(body, database);
+    OpenNavigationHeader(html, database);
 
-    auto table = box->AddTable();
-    table->SetAttribute("class", "form");
-    auto row = table->AddTableRow();
-    row->SetAttribute("class", "form");
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
 
-    auto cell = row->AddTableCell();
-    cell->SetAttribute("class", "form fill");
+    html.Element("td", {}, {{"class", "form fill"}});
 
     if (!isItem)
     {
-        cell = row->AddTableCell();
-        cell->SetAttribute("class", "form link");
-        auto div = cell->AddDivision();
-        div->SetAttribute("class", "box");
-        div->AddImage("48-floppy.png", "Save Rules", 40);
-        div->SetAttribute("onclick", "submitRule('form')");
-        body->AddScript("submitRule.js");
-    }
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    auto div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    int prevId = database.Unassigned.PrevItem(id);
-    if (prevId >= 0)
-    {
-        std::string link = fmt::format("{}?id={}", HtmlGenerator::ITEM_HTML, prevId);
-        div->AddHyperlinkImage(link, "Previous Warning", "48-sign-left-y.png", 38);
-    }
-    else
-    {
-        div->AddImage("48-sign-left-g.png", "No Warnings", 38);
-    }
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    int nextId = database.Unassigned.NextItem(id);
-    if (nextId >= 0)
-    {
-        std::string link = fmt::format("{}?id={}", HtmlGenerator::ITEM_HTML, nextId);
-        div->AddHyperlinkImage(link, "Next Warning", "48-sign-right-y.png", 38);
-    }
-    else
-    {
-        div->AddImage("48-sign-right-g.png", "No Warnings", 38);
+        html.Open("td");
+        html.Attribute("class", "form link");
+        html.Open("div");
+        html.Attribute("class", "box");
+        html.Attribute("onclick", "submitRule('form')");
+        html.Image("48-floppy.png", "Save Rules", 40);
+        html.Close();
+        html.Close();
     }
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    prevId = database.Issues.PrevItem(id);
-    if (prevId >= 0)
-    {
-        std::string link = fmt::format("{}?id={}", HtmlGenerator::ITEM_HTML, prevId);
-        div->AddHyperlinkImage(link, "Previous Error", "48-sign-left-r.png", 38);
-    }
-    else
-    {
-        div->AddImage("48-sign-left-g.png", "No Errors", 38);
-    }
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form link");
-    div = cell->AddDivision();
-    div->SetAttribute("class", "box");
-    nextId = database.Issues.NextItem(id);
-    if (nextId >= 0)
-    {
-        std::string link = fmt::format("{}?id={}", HtmlGenerator::ITEM_HTML, nextId);
-        div->AddHyperlinkImage(link, "Next Error", "48-sign-right-r.png", 38);
-    }
-    else
+    AddNavigationCell(html, GetItemLink(database.Unassigned.PrevItem(id)), "Previous Warning",
+                      "48-sign-left-y.png", "No Warnings", "48-sign-left-g.png");
+    AddNavigationCell(html, GetItemLink(database.Unassigned.NextItem(id)), "Next Warning", "48-sign-right-y.png",
+                      "No Warnings", "48-sign-right-g.png");
+    AddNavigationCell(html, GetItemLink(database.Issues.PrevItem(id)), "Previous Error", "48-sign-left-r.png",
+                      "No Errors", "48-sign-left-g.png");
+    AddNavigationCell(html, GetItemLink(database.Issues.NextItem(id)), "Next Error", "48-sign-right-r.png",
+                      "No Errors", "48-sign-right-g.png");
+    html.Close(); // tr
+    html.Close(); // table
+    CloseNavigationHeader(html);
+    if (!isItem)
     {
-        div->AddImage("48-sign-right-g.png", "No Errors", 38);
+        html.Script("submitRule.js");
     }
 
-    auto main = body->AddMain();
-    main->SetAttribute("class", "pad-100");
+    html.Open("main");
+    html.Attribute("class", "pad-100");
 
-    main->AddHeading(2, title);
+    html.Element("h2", title);
 
-    table = main->AddTable();
-    table->SetAttribute("class", "form");
-    row = table->AddTableRow();
-    row->SetAttribute("class", "form");
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
+    html.Attribute("class", "form");
 
     if (!isItem)
     {
-        cell = row->AddTableCell();
-        cell->AddImage("48-sign-delete.png", "Delete this rule", 38);
-        cell->SetAttribute("class", "form link");
-        cell->SetAttribute("onclick", fmt::format("deleteRule('{}', '{}')", DELETE_CMD, id));
-        body->AddScript("deleteRule.js");
+        html.Open("td");
+        html.Attribute("class", "form link");
+        html.Attribute("onclick", fmt::format("deleteRule('{}', '{}')", DELETE_CMD, id));
+        html.Image("48-sign-delete.png", "Delete this rule", 38);
+        html.Close();
     }
 
-    row->SetAttribute("class", "form");
-    cell = row->AddTableCell();
+    html.Element("td");
 
-    cell = row->AddTableCell(fmt::format("{}:{}", item->File.string(), item->Line));
-    cell->SetAttribute("class", "form mono fill center");
+    const fs::path file = item->GetFile().ToString();
+    html.Element("td", fmt::format("{}:{}", file.string(), item->GetLine()), {{"class", "form mono fill center"}});
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-    std::string link = fmt::format("{}?file={}", HtmlGenerator::EDIT_HTML, item->File.string());
-    cell->AddHyperlinkImage(link, "Open folder", "48-notepad.png", 38);
+    html.Open("td");
+    html.Attribute("class", "form");
+    std::string link = fmt::format("{}?file={}", HtmlGenerator::EDIT_HTML, file.string());
+    html.HyperlinkImage(link, "Open folder", "48-notepad.png", 38);
+    html.Close();
 
-    cell = row->AddTableCell();
-    cell->SetAttribute("class", "form");
-    link = fmt::format("{}?folder={}", HtmlGenerator::OPEN_CMD, item->File.parent_path().string());
-    cell->AddHyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.Open("td");
+    html.Attribute("class", "form");
+    link = fmt::format("{}?folder={}", HtmlGenerator::OPEN_CMD, file.parent_path().string());
+    html.HyperlinkImage(link, "Open folder", "48-folder.png", 38);
+    html.Close();
 
-    fs::path formatFile = item->File.parent_path() / "format.ini";
-    if (Utils::ToLower(item->File.extension().string()) == ".csv" && fs::exists(formatFile))
+    fs::path formatFile = file.parent_path() / "format.ini";
+    if (Utils::ToLower(file.extension().string()) == ".csv" && fs::exists(formatFile))
     {
-        cell = row->AddTableCell();
-        cell->SetAttribute("class", "form");
+        html.Open("td");
+        html.Attribute("class", "form");
         link = fmt::format("{}?file={}", HtmlGenerator::EDIT_HTML, formatFile.string());
-        cell->AddHyperlinkImage(link, "Open corresponding format file", "48-wrench-screwdriver.png", 38);
+        html.HyperlinkImage(link, "Open corresponding format file", "48-wrench-screwdriver.png", 38);
+        html.Close();
     }
+    html.Close(); // tr
+    html.Close(); // table
 
     if (!item->Issues.empty() || item->References.empty())
     {
-        // main->AddHeading(3, "Issues:");
-        table = main->AddTable();
-        table->SetAttribute("class", "err mar-20");
+        html.Open("table");
+        html.Attribute("class", "err mar-20");
 
         if (item->References.empty())
         {
-            row = table->AddTableRow();
-            cell = row->AddTableCell();
-            cell->AddImage("48-sign-warning.png", "warning", 20);
+            html.Open("tr");
+            html.Open("td");
+            html.Image("48-sign-warning.png", "warning", 20);
+            html.Close();
 
             if (isItem)
             {
-                cell = row->AddTableCell("WARNING: Item has no matching rule");
+                html.Element("td", "WARNING: Item has no matching rule", {{"class", "warn fill"}});
             }
             else
             {
-                cell = row->AddTableCell("WARNING: Rule has no matching item(s)");
+                html.Element("td", "WARNING: Rule has no matching item(s)", {{"class", "warn fill"}});
             }
-            cell->SetAttribute("class", "warn fill");
+            html.Close();
         }
 
         for (auto& issue : item->Issues)
         {
-            row = table->AddTableRow();
-            cell = row->AddTableCell();
-            cell->AddImage("48-sign-error.png", "error", 20);
-            cell = row->AddTableCell(issue);
-            cell->SetAttribute("class", "err fill");
+            html.Open("tr");
+            html.Open("td");
+            html.Image("48-sign-error.png", "error", 20);
+            html.Close();
+            html.Element("td", issue, {{"class", "err fill"}});
+            html.Close();
         }
+        html.Close();
     }
 
-    auto form = main->AddForm();
-    form->SetAttribute("action", HtmlGenerator::SAVE_RULE_CMD);
-    form->SetAttribute("method", "get");
-    form->SetAttribute("enctype", "text/plain");
-    form->SetAttribute("id", "form");
-    auto input = form->AddInput();
-    input->SetAttribute("name", "id");
-    input->SetAttribute("type", "hidden");
-    input->SetAttribute("value", fmt::format("{}", item->Id));
-    input = form->AddInput();
-    input->SetAttribute("name", "format");
-    input->SetAttribute("type", "hidden");
-    input->SetAttribute("value", item->Date.GetFormat());
-
-    div = form->AddDivision();
-    table = div->AddTable();
+    html.Open("form");
+    html.Attribute("action", HtmlGenerator::SAVE_RULE_CMD);
+    html.Attribute("method", "get");
+    html.Attribute("enctype", "text/plain");
+    html.Attribute("id", "form");
+    html.Element("input", {}, {{"name", "id"}, {"type", "hidden"}, {"value", std::to_string(item->Id)}});
+    html.Element("input", {}, {{"name", "format"}, {"type", "hidden"}, {"value", item->GetDate().GetFormat()}});
+
+    html.Open("div");
+    html.Open("table");
 
     if (isItem)
     {
-        table->SetAttribute("class", "rule mar-20");
-        AddItemTableHeader(table);
-        AddItemTableRow(table, item.get());
+        html.Attribute("class", "rule mar-20");
+        AddItemTableHeader(html);
+        AddItemTableRow(html, item.get());
     }
     else
     {
-        table->SetAttribute("class", "form mar-20");
-
-        auto row2 = table->AddTableRow();
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form fill");
-        cell->SetAttribute("colspan", "2");
-        auto label = cell->AddLabel("Category");
-        label->SetAttribute("class", "marb-5");
-
-        auto select = label->AddSelect();
-        select->SetAttribute("class", "form mono");
-        select->SetAttribute("name", "Category");
-        select->SetAttribute("id", "Category");
-        select->SetAttribute("onchange", "submitRule('form')");
-
-        auto option = select->AddOption("NEW CATEGORY...");
-        select->AddOption("NEW IGNORE CATEGORY...");
-        std::vector<std::string> categories = database.GetCategories();
+        html.Attribute("class", "form mar-20");
+
+        html.Open("tr");
+        html.Open("td");
+        html.Attribute("class", "form fill");
+        html.Attribute("colspan", "2");
+        html.Open("label", true);
+        html.Attribute("class", "marb-5");
+        html.Text("Category");
+
+        html.Open("select");
+        html.Attribute("class", "form mono");
+        html.Attribute("name", "Category");
+        html.Attribute("id", "Category");
+        html.Attribute("onchange", "submitRule('form')");
+
+        html.Element("option", "NEW CATEGORY...", {{"value", "NEW CATEGORY..."}});
+        html.Element("option", "NEW IGNORE CATEGORY...", {{"value", "NEW IGNORE CATEGORY..."}});
+        std::vector<CsvSymbol> categories = database.GetCategories();
         if (!categories.empty())
         {
-            option = select->AddOption("--------------------");
-            option->SetAttribute("disabled", "");
+            html.Element("option", "--------------------", {{"value", "--------------------"}, {"disabled", ""}});
         }
         for (auto& category : categories)
         {
-            option = select->AddOption(category);
-            if (item->Category == category)
+            const std::string& name = category.ToString();
+            html.Open("option", !name.empty());
+            html.Attribute("value", name);
+            if (item->GetCategory() == category)
             {
-                option->SetAttribute("selected", "");
+                html.Attribute("selected", "");
             }
+            if (!name.empty())
+            {
+                html.Text(name);
+            }
+            html.Close();
         }
-
-        row2 = table->AddTableRow();
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form");
-        cell->SetAttribute("style", "width:75%");
-        label = cell->AddLabel("Payer/Payee (Regex)");
-        label->SetAttribute("class", "marb-5");
-        input = label->AddInput();
-        input->SetAttribute("name", "PayerPayee");
-        input->SetAttribute("id", "PayerPayee");
-        input->SetAttribute("type", "text");
-        input->SetAttribute("class", "form mono");
-        input->SetAttribute("placeholder", "...");
-        input->SetAttribute("value", item->PayerPayee);
-
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form");
-        cell->SetAttribute("style", "width:25%");
-        label = cell->AddLabel(fmt::format("Date ({})", item->Date.GetFormat()));
-        label->SetAttribute("class", "marb-5");
-        input = label->AddInput();
-        input->SetAttribute("name", "Date");
-        input->SetAttribute("id", "Date");
-        input->SetAttribute("type", "text");
-        input->SetAttribute("class", "form mono");
-        input->SetAttribute("placeholder", item->Date.GetFormat());
-        input->SetAttribute("value", item->Date.ToString());
-
-        row2 = table->AddTableRow();
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form");
-        cell->SetAttribute("style", "width:75%");
-        label = cell->AddLabel("Description (Regex)");
-        label->SetAttribute("class", "marb-5");
-        input = label->AddInput();
-        input->SetAttribute("name", "Description");
-        input->SetAttribute("id", "Description");
-        input->SetAttribute("type", "text");
-        input->SetAttribute("class", "form mono");
-        input->SetAttribute("placeholder", "...");
-        input->SetAttribute("value", item->Description);
-
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form");
-        cell->SetAttribute("style", "width:25%");
-        label = cell->AddLabel("Account (Regex)");
-        label->SetAttribute("class", "marb-5");
-        input = label->AddInput();
-        input->SetAttribute("name", "Account");
-        input->SetAttribute("id", "Account");
-        input->SetAttribute("type", "text");
-        input->SetAttribute("class", "form mono");
-        input->SetAttribute("placeholder", "...");
-        input->SetAttribute("value", item->Account);
-
-        row2 = table->AddTableRow();
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form");
-        cell->SetAttribute("style", "width:75%");
-        label = cell->AddLabel("Type (Regex)");
-        label->SetAttribute("class", "marb-20");
-        input = label->AddInput();
-        input->SetAttribute("name", "Type");
-        input->SetAttribute("id", "Type");
-        input->SetAttribute("type", "text");
-        input->SetAttribute("class", "form mono");
-        input->SetAttribute("placeholder", "...");
-        input->SetAttribute("value", item->Type);
-
-        cell = row2->AddTableCell();
-        cell->SetAttribute("class", "form");
-        cell->SetAttribute("style", "width:25%");
-        label = cell->AddLabel("Value (number)");
-        label->SetAttribute("class", "marb-20");
-        input = label->AddInput();
-        input->SetAttribute("name", "Value");
-        input->SetAttribute("id", "Value");
-        input->SetAttribute("type", "text");
-        input->SetAttribute("class", "form mono");
-        input->SetAttribute("placeholder", "0.00");
-        input->SetAttribute("value", item->Value.ToString());
+        html.Close(); // select
+        html.Close(); // label
+        html.Close(); // td
+        html.Close(); // tr
+
+        const std::string dateFormat = item->GetDate().GetFormat();
+        html.Open("tr");
+        AddRuleInput(html, "width:75%", "Payer/Payee (Regex)", "marb-5", "PayerPayee", "...", item->GetPayerPayee());
+        AddRuleInput(html, "width:25%", fmt::format("Date ({})", dateFormat), "marb-5", "Date", dateFormat,
+                     item->GetDate().ToString());
+        html.Close();
+
+        html.Open("tr");
+        AddRuleInput(html, "width:75%", "Description (Regex)", "marb-5", "Description", "...", item->GetDescription());
+        AddRuleInput(html, "width:25%", "Account (Regex)", "marb-5", "Account", "...", item->GetAccount().ToString());
+        html.Close();
+
+        html.Open("tr");
+        AddRuleInput(html, "width:75%", "Type (Regex)", "marb-20", "Type", "...", item->GetType().ToString());
+        AddRuleInput(html, "width:25%", "Value (number)", "marb-20", "Value", "0.00", item->GetValue().ToString());
+        html.Close();
     }
+    html.Close(); // table
+    html.Close(); // div
+    html.Close(); // form
 
     if (isItem)
     {
-        auto heading = main->AddHeading(3, "Rule(s):");
-        heading->SetAttribute("class", "mar-20");
+        html.Element("h3", "Rule(s):", {{"class", "mar-20"}});
     }
     else
     {
-        auto heading = main->AddHeading(3, "Item(s):");
-        heading->SetAttribute("class", "mar-20");
+        html.Element("h3", "Item(s):", {{"class", "mar-20"}});
     }
 
-    table = main->AddTable();
-    table->SetAttribute("class", "form");
-    row = table->AddTableRow();
-    row->SetAttribute("class", "form");
-    cell = row->AddTableCell();
+    html.Open("table");
+    html.Attribute("class", "form");
+    html.Open("tr");
+    html.Attribute("class", "form");
     if (isItem)
     {
-        cell->SetAttribute("class", "form link");
-        cell->AddImage("48-sign-add.png", "Add new rule", 38);
-        cell->SetAttribute("onclick", fmt::format("window.location='{}?id={}';", NEW_CMD, id));
-
-        cell = row->AddTableCell();
+        html.Open("td");
+        html.Attribute("class", "form link");
+        html.Attribute("onclick", fmt::format("window.location='{}?id={}';", NEW_CMD, id));
+        html.Image("48-sign-add.png", "Add new rule", 38);
+        html.Close();
     }
-    cell->SetAttribute("class", "form");
-    cell->AddText("&nbsp;");
-    cell->SetAttribute("style", "width: 50%;");
-
-    cell = row->AddTableCell();
-    cell->SetAttribute("style", "width: 50%;");
-    cell->SetAttribute("class", "form");
-    input = cell->AddInput();
-    input->SetAttribute("id", "filter");
-    input->SetAttribute("type", "text");
-    input->SetAttribute("placeholder", "Filter...");
-    input->SetAttribute("title", "Type in a string");
-    input->SetAttribute("oninput", "filterTable('table', 'filter')");
-    input->SetAttribute("class", "filter");
-    body->AddScript("filterTable.js");
-
-    table = main->AddDivision()->AddTable();
-    table->SetAttribute("class", "item mar-20");
-    table->SetAttribute("id", "table");
-    AddItemTableHeader(table);
+    html.Open("td");
+    html.Attribute("class", "form");
+    html.Attribute("style", "width: 50%;");
+    html.Text("&nbsp;");
+    html.Close();
+
+    html.Open("td");
+    html.Attribute("style", "width: 50%;");
+    html.Attribute("class", "form");
+    html.Element("input", {},
+                 {{"id", "filter"},
+                  {"type", "text"},
+                  {"placeholder", "Filter..."},
+                  {"title", "Type in a string"},
+                  {"oninput", "filterTable('table', 'filter')"},
+                  {"class", "filter"}});
+    html.Close();
+    html.Close(); // tr
+    html.Close(); // table
+
+    html.Open("div");
+    html.Open("table");
+    html.Attribute("class", "item mar-20");
+    html.Attribute("id", "table");
+    AddItemTableHeader(html);
 
     for (auto& ref : item->References)
     {
-        AddItemTableRow(table, ref);
+        AddItemTableRow(html, ref);
     }
+    html.Close(); // table
+    html.Close(); // div
+    html.Close(); // main
 
-    return html.ToString();
-}
-
-void HtmlGenerator::AddItemTableRow(HtmlElement* table, CsvItem* row)
-{
-    std::string rowStyle = "link";
-    if (row->References.size() == 0)
-    {
-        rowStyle += " unassigned";
-    }
-    if (row->Issues.size() > 0)
+    if (!isItem)
     {
-        rowStyle += " issue";
+        html.Script("deleteRule.js");
     }
+    html.Script("filterTable.js");
 
-    std::string colorStyle{};
-    try
-    {
-        if (row->Value.ToDouble() < 0)
-        {
-            colorStyle = "neg";
-        }
-        else if (row->Value.ToDouble() > 0)
-        {
-            colorStyle = "pos";
-        }
-    }
-    catch (const std::exception&)
-    {
-        colorStyle = "";
-    }
+    return html.Finish();
+}
 
-    auto htmlRow = table->AddTableRow();
-    htmlRow->SetAttribute("class", rowStyle);
-    htmlRow->SetAttribute("onclick", fmt::format("window.location='{}?id={}';", ITEM_HTML, row->Id));
-
-    auto cell = htmlRow->AddTableCell(fmt::format("{}", row->Id));
-    htmlRow->AddTableCell(row->Category.empty() ? "&nbsp;" : row->Category);
-    htmlRow->AddTableCell(row->PayerPayee.empty() ? "&nbsp;" : row->PayerPayee);
-    htmlRow->AddTableCell(row->Description.empty() ? "&nbsp;" : row->Description);
-    htmlRow->AddTableCell(row->Type.empty() ? "&nbsp;" : row->Type);
-    htmlRow->AddTableCell(row->Date.ToString().empty() ? "&nbsp;" : row->Date.ToString());
-    htmlRow->AddTableCell(row->Account.empty() ? "&nbsp;" : row->Account);
-    cell = htmlRow->AddTableCell(row->Value.ToString().empty() ? "&nbsp;" : row->Value.ToString());
-    cell->SetAttribute("class", colorStyle);
+void HtmlGenerator::AddItemTableRow(HtmlWriter& html, CsvItem* row)
+{
+    html.Open("tr");
+    html.Attribute("class", GetRowStyle(row));
+    html.Attribute("onclick", fmt::format("window.location='{}?id={}';", ITEM_HTML, row->Id));
+
+    html.Element("td", fmt::format("{}", row->Id));
+    html.Element("td", row->GetCategory().IsEmpty() ? "&nbsp;" : row->GetCategory().ToString());
+    html.Element("td", row->GetPayerPayee().empty() ? "&nbsp;" : row->GetPayerPayee());
+    html.Element("td", row->GetDescription().empty() ? "&nbsp;" : row->GetDescription());
+    html.Element("td", row->GetType().IsEmpty() ? "&nbsp;" : row->GetType().ToString());
+    html.Element("td", row->GetDate().IsEmpty() ? "&nbsp;" : row->GetDate().ToString());
+    html.Element("td", row->GetAccount().IsEmpty() ? "&nbsp;" : row->GetAccount().ToString());
+    html.Element("td", row->GetValue().IsEmpty() ? "&nbsp;" : row->GetValue().ToString(),
+                 {{"class", GetValueStyle(row)}});
+    html.Close();
 }
 
 } // namespace hokee
\ No newline at end of file
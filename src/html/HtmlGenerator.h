@@ -1,20 +1,50 @@
 #pragma once
 
-#include "HtmlElement.h"
+#include "HtmlWriter.h"
 #include "Utils.h"
 #include "csv/CsvDatabase.h"
 
+#include <algorithm>
 #include <array>
 #include <sstream>
 namespace hokee
 {
+/// Rows [Offset, Offset + Limit) shown by a paginated table page
+struct HtmlTableWindow
+{
+    /// Urls of the page and of its JSON rows, without offset and limit parameters
+    std::string PageLink{};
+    std::string RowsLink{};
+    size_t Offset{0};
+    /// 0: all rows, without page navigation
+    size_t Limit{0};
+    /// Query of the server-side search, which selected the rows (see CsvDatabase::Search())
+    std::string Search{};
+
+    /// First row of the window in a table of rowCount rows
+    inline size_t GetBegin(size_t rowCount) const
+    {
+        return Limit > 0 ? std::min(Offset, rowCount) : 0;
+    }
+
+    /// Row behind the window in a table of rowCount rows, computed without overflow for any offset and limit
+    inline size_t GetEnd(size_t rowCount) const
+    {
+        const size_t begin = GetBegin(rowCount);
+        return Limit > 0 ? begin + std::min(Limit, rowCount - begin) : rowCount;
+    }
+};
+
 class HtmlGenerator
 {
-    static HtmlElement* AddHtmlHead(HtmlElement* html);
-    static HtmlElement* AddNavigationHeader(HtmlElement* body, const CsvDatabase& database);
-    static void AddSummaryTableHeader(HtmlElement* table, int minYear, int maxYear);
-    static void AddItemTableHeader(HtmlElement* table);
-    static void AddItemTableRow(HtmlElement* table, CsvItem* row);
+    static void AddHtmlHead(HtmlWriter& html, bool refresh = false);
+    /// Opens the navigation box, which stays open for additional tables until CloseNavigationHeader()
+    static void OpenNavigationHeader(HtmlWriter& html, const CsvDatabase& database);
+    static void CloseNavigationHeader(HtmlWriter& html);
+    static void AddSummaryTableHeader(HtmlWriter& html, int minYear, int maxYear);
+    static void AddItemTableHeader(HtmlWriter& html);
+    static void AddItemTableRow(HtmlWriter& html, CsvItem* row);
+    static void AddPageNavigation(HtmlWriter& html, const HtmlTableWindow& window, size_t rowCount);
 
   public:
     HtmlGenerator() = delete;
@@ -59,13 +89,23 @@ class HtmlGenerator
     static std::string GetItemPage(const CsvDatabase& database, int id, int flag);
     static std::string GetEditPage(const CsvDatabase& database, const fs::path& file, bool saved);
     static std::string GetSettingsPage(const CsvDatabase& database, const fs::path& file, bool saved);
-    static std::string GetTablePage(const CsvDatabase& database, std::string title, const CsvTable& data, int filter);
+    static std::string GetTablePage(const CsvDatabase& database, std::string title, const CsvTable& data,
+                                    int filter, const HtmlTableWindow& window = {});
+
+    /// GetTablePage() in parts, so the rows of large tables can be sent while they are written
+    static void BeginTablePage(HtmlWriter& html, const CsvDatabase& database, std::string title, int filter,
+                               size_t rowCount, const HtmlTableWindow& window = {});
+    static void AddTableRows(HtmlWriter& html, const std::vector<CsvRowShared>& rows, size_t begin, size_t end);
+    static void EndTablePage(HtmlWriter& html, const HtmlTableWindow& window = {});
+
+    /// Rows [offset, offset + limit) as JSON, for the tables of paginated pages to load more rows while scrolling
+    static std::string GetTableRows(const std::vector<CsvRowShared>& rows, size_t offset, size_t limit);
 
     static std::string GetEmptyInputPage();
 
-    static void AddInputForm(HtmlElement* table, const std::string& name, const std::string& value,
+    static void AddInputForm(HtmlWriter& html, const std::string& name, const std::string& value,
                              const std::string& description);
-    static HtmlElement* AddButton(HtmlElement* tableRow, const std::string& link, const std::string& tooltip,
+    static void AddButton(HtmlWriter& html, const std::string& link, const std::string& tooltip,
                           const std::string& image, const std::string& text, const std::string& style = "");
 };
 
@@ -0,0 +1,180 @@
+#include "HtmlWriter.h"
+#include "InternalException.h"
+
+#include <fmt/format.h>
+
+namespace hokee
+{
+HtmlWriter::HtmlWriter()
+{
+    _output += "<!DOCTYPE html>\n<html";
+    _elements.push_back({"html", 0, false, false});
+    Attribute("lang", "en");
+}
+
+void HtmlWriter::BeginContent()
+{
+    if (_elements.empty())
+    {
+        throw InternalException(__FILE__, __LINE__, "Html document is already finished.");
+    }
+    OpenElement& parent = _elements.back();
+    if (!parent.HasContent)
+    {
+        _output += '>';
+        parent.HasContent = true;
+    }
+    if (!parent.PrintInline)
+    {
+        _output += '\n';
+        _output.append(static_cast<size_t>(parent.Indent + 2), ' ');
+    }
+}
+
+void HtmlWriter::Open(std::string_view name, bool printInline)
+{
+    BeginContent();
+    _output += '<';
+    _output += name;
+    _elements.push_back({std::string(name), _elements.back().Indent + 2, printInline, false});
+}
+
+void HtmlWriter::Attribute(std::string_view name, std::string_view value)
+{
+    if (_elements.empty() || _elements.back().HasContent)
+    {
+        throw InternalException(__FILE__, __LINE__,
+                                fmt::format("Could not write attribute '{}' after the element content.", name));
+    }
+    _output += ' ';
+    _output += name;
+    _output += "=\"";
+    _output += value;
+    _output += '"';
+}
+
+void HtmlWriter::Text(std::string_view text)
+{
+    BeginContent();
+    _output += text;
+}
+
+void HtmlWriter::EscapedText(std::string_view text)
+{
+    BeginContent();
+    for (const char character : text)
+    {
+        switch (character)
+        {
+            case '&':
+                _output += "&amp;";
+                break;
+            case '\"':
+                _output += "&quot;";
+                break;
+            case '\'':
+                _output += "&apos;";
+                break;
+            case '<':
+                _output += "&lt;";
+                break;
+            case '>':
+                _output += "&gt;";
+                break;
+            default:
+                _output += character;
+                break;
+        }
+    }
+}
+
+void HtmlWriter::Close()
+{
+    if (_elements.empty())
+    {
+        throw InternalException(__FILE__, __LINE__, "Could not close element, no element is open.");
+    }
+    const OpenElement& element = _elements.back();
+    if (!element.HasContent)
+    {
+        _output += "/>";
+    }
+    else
+    {
+        if (!element.PrintInline)
+        {
+            _output += '\n';
+            _output.append(static_cast<size_t>(element.Indent), ' ');
+        }
+        _output += "</";
+        _output += element.Name;
+        _output += '>';
+    }
+    _elements.pop_back();
+}
+
+void HtmlWriter::Element(std::string_view name, std::string_view text, Attributes attributes)
+{
+    Open(name, !text.empty());
+    for (auto& attribute : attributes)
+    {
+        Attribute(attribute.first, attribute.second);
+    }
+    if (!text.empty())
+    {
+        Text(text);
+    }
+    Close();
+}
+
+void HtmlWriter::Image(std::string_view src, std::string_view title, int width, int height)
+{
+    Element("img", {},
+            {{"src", src},
+             {"title", title},
+             {"width", std::to_string(width)},
+             {"height", std::to_string(height)}});
+}
+
+void HtmlWriter::Image(std::string_view src, std::string_view title, int size)
+{
+    Image(src, title, size, size);
+}
+
+void HtmlWriter::HyperlinkImage(std::string_view link, std::string_view title, std::string_view src, int size)
+{
+    Open("a", true);
+    Attribute("href", link);
+    Attribute("title", title);
+    Image(src, title, size);
+    Close();
+}
+
+void HtmlWriter::Script(std::string_view src)
+{
+    Element("script", " ", {{"src", src}});
+}
+
+void HtmlWriter::Progress(size_t value, size_t max)
+{
+    Element("progress", fmt::format("{}%", value),
+            {{"value", std::to_string(value)}, {"max", std::to_string(max)}});
+}
+
+std::string HtmlWriter::Flush()
+{
+    std::string output;
+    output.swap(_output);
+    _output.reserve(output.capacity());
+    return output;
+}
+
+std::string HtmlWriter::Finish()
+{
+    while (!_elements.empty())
+    {
+        Close();
+    }
+    return std::move(_output);
+}
+} // namespace hokee
\ No newline at end of file
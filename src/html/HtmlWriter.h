@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hokee
+{
+/// Writes a html document directly into a growing buffer, without building a tree of HtmlElements first.
+/// The markup is the same as HtmlElement::ToString().
+/// Attributes have to be written before the content of an element.
+class HtmlWriter
+{
+    struct OpenElement
+    {
+        std::string Name;
+        int Indent;
+        bool PrintInline;
+        bool HasContent;
+    };
+
+    std::string _output{};
+    std::vector<OpenElement> _elements{};
+
+    void BeginContent();
+
+  public:
+    typedef std::initializer_list<std::pair<std::string_view, std::string_view>> Attributes;
+
+    /// Starts the document and opens the html element
+    HtmlWriter();
+    ~HtmlWriter() = default;
+
+    HtmlWriter(const HtmlWriter&) = delete;
+    HtmlWriter& operator=(const HtmlWriter&) = delete;
+    HtmlWriter(HtmlWriter&&) = delete;
+    HtmlWriter& operator=(HtmlWriter&&) = delete;
+
+    /// Content of inline elements is not indented, like the content of a HtmlElement created with a text
+    void Open(std::string_view name, bool printInline = false);
+    void Attribute(std::string_view name, std::string_view value);
+    void Text(std::string_view text);
+    /// Escapes '&', '"', '\'', '<' and '>' like Utils::EscapeHtml()
+    void EscapedText(std::string_view text);
+    void Close();
+
+    /// Element with attributes and an optional text.
+    /// Like HtmlElement(name, text), it is printed inline if it has a text.
+    void Element(std::string_view name, std::string_view text = {}, Attributes attributes = {});
+
+    void Image(std::string_view src, std::string_view title, int width, int height);
+    void Image(std::string_view src, std::string_view title, int size);
+    void HyperlinkImage(std::string_view link, std::string_view title, std::string_view src, int size);
+    void Script(std::string_view src);
+    void Progress(size_t value, size_t max);
+
+    /// Returns the output written so far and clears it, the open elements stay open
+    std::string Flush();
+
+    /// Closes all open elements and returns the document (or the rest of it after Flush())
+    std::string Finish();
+};
+} // namespace hokee
\ No newline at end of file
@@ -33,4 +33,21 @@ function filterTable(tableId, filterId)
             tr[i].style.display = 'none';
         }
     }
+}
+
+function searchTable(filterId)
+{
+    var params, search;
+    params = new URLSearchParams(window.location.search);
+    search = document.getElementById(filterId).value.trim();
+    params.delete('offset');
+    if (search == '')
+    {
+        params.delete('search');
+    }
+    else
+    {
+        params.set('search', search);
+    }
+    window.location.search = params.toString();
 }
\ No newline at end of file
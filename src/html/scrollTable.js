@@ -0,0 +1,54 @@
+var loadingRows = false;
+
+function appendRows(table, json)
+{
+    var body, tr, td, i, j;
+    body = table.tBodies.length > 0 ? table.tBodies[0] : table;
+    for (i = 0; i < json.rows.length; i++)
+    {
+        tr = document.createElement('tr');
+        tr.className = json.rows[i].class;
+        tr.setAttribute('onclick', "window.location='item.html?id=" + json.rows[i].id + "';");
+        td = document.createElement('td');
+        td.textContent = json.rows[i].id;
+        tr.appendChild(td);
+        for (j = 0; j < json.rows[i].cells.length; j++)
+        {
+            td = document.createElement('td');
+            td.textContent = json.rows[i].cells[j] == '' ? '\u00a0' : json.rows[i].cells[j];
+            tr.appendChild(td);
+        }
+        td.className = json.rows[i].valueClass;
+        body.appendChild(tr);
+    }
+    table.dataset.offset = json.offset + json.rows.length;
+}
+
+function scrollTable(tableId, filterId)
+{
+    var table, offset, url;
+    table = document.getElementById(tableId);
+    offset = parseInt(table.dataset.offset);
+    if (loadingRows || offset >= parseInt(table.dataset.count)
+        || window.innerHeight + window.scrollY < document.body.offsetHeight - window.innerHeight)
+    {
+        return;
+    }
+
+    loadingRows = true;
+    url = table.dataset.rows + (table.dataset.rows.indexOf('?') < 0 ? '?' : '&');
+    fetch(url + 'offset=' + offset + '&limit=' + table.dataset.limit)
+        .then(function(response) { return response.json(); })
+        .then(function(json)
+        {
+            appendRows(table, json);
+            if (document.getElementById(filterId).value != '')
+            {
+                filterTable(tableId, filterId);
+            }
+            loadingRows = false;
+        })
+        .catch(function() { loadingRows = false; });
+}
+
+window.addEventListener('scroll', function() { scrollTable('table', 'filter'); });
\ No newline at end of file
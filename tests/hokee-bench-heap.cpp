@@ -0,0 +1,38 @@
+#include "hokee-bench-heap.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<size_t> _heapAllocations{0};
+} // namespace
+
+size_t GetHeapAllocationCount()
+{
+    return _heapAllocations;
+}
+
+// Count heap allocations, to compare them with the arena allocations of CsvDatabase::Load. The array, nothrow
+// and sized forms call these by default.
+void* operator new(std::size_t size)
+{
+    ++_heapAllocations;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*unused*/) noexcept
+{
+    std::free(p);
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+/// Number of global operator new calls since program start. The replacement operators live in their own
+/// translation unit, so they are never inlined into callers, where the malloc/free pairing would be reported as
+/// mismatched new/delete.
+size_t GetHeapAllocationCount();
\ No newline at end of file
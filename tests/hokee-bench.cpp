@@ -0,0 +1,753 @@
+#include "InternalException.h"
+#include "Utils.h"
+#include "csv/CsvArena.h"
+#include "csv/CsvColumns.h"
+#include "csv/CsvDatabase.h"
+#include "csv/CsvParser.h"
+#include "csv/CsvPattern.h"
+#include "csv/CsvPatternCache.h"
+#include "csv/CsvRule.h"
+#include "csv/CsvRuleFilter.h"
+#include "csv/CsvScanner.h"
+#include "csv/CsvSummary.h"
+#include "csv/CsvTextIndex.h"
+#include "hokee-bench-heap.h"
+#include "hokee.h"
+#include "html/HtmlElement.h"
+#include "html/HtmlGenerator.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <thread>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace hokee;
+
+namespace
+{
+size_t _chunkedParserMegabytes = 1024;
+
+std::string GenerateCsv(size_t lines, size_t first = 0)
+{
+    std::string csv;
+    for (size_t i = first; i < first + lines; ++i)
+    {
+        csv += fmt::format("\"{:02}.{:02}.{}\";\"receipt {} for something\";\"Supermarket {}\";\"-{},{:02}\"\n",
+                           i % 28 + 1, i % 12 + 1, 2010 + i % 10, i * 7919, i % 100, i % 1000, i % 100);
+    }
+    return csv;
+}
+
+void WriteFormat(const fs::path& formatFile)
+{
+    std::ofstream format(formatFile);
+    format << "FormatName=BENCH\nAccountOwner=Mr. X\nColumnNames=date;description;payer/payee;value\n"
+           << "HasHeader=true\nIgnoreLines=1\nHasDoubleQuotes=true\nHasTrailingDelimiter=false\n"
+           << "Delimiter=;\nDateFormat=dd.mm.yyyy\nCategory=-1\nPayerPayee=2\nPayer=-1\nPayee=-1\n"
+           << "Description=1\nType=-1\nDate=0\nAccount=-1\nValue=3";
+}
+
+/// Resident set size of the process (0 if unknown)
+size_t GetResidentBytes()
+{
+#ifdef __linux__
+    size_t pages = 0;
+    size_t residentPages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+double Measure(const std::function<void()>& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+} // namespace
+
+void runBenchmark(const std::string& name, std::function<void(void)> benchmark)
+{
+    Utils::PrintInfo(name);
+    Utils::PrintInfo("---------------------------------------------------------------------");
+    benchmark();
+    Utils::PrintInfo("+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++");
+}
+
+void SplitLineBenchmark()
+{
+    const size_t lineCount = 1000000;
+    std::string csv = GenerateCsv(lineCount);
+    const double megabytes = static_cast<double>(csv.size()) / (1024 * 1024);
+
+    size_t splitLineCellCount = 0;
+    const double splitLineTime = Measure([&] {
+        size_t begin = 0;
+        while (begin < csv.size())
+        {
+            size_t end = csv.find('\n', begin);
+            std::string line = csv.substr(begin, end - begin);
+            splitLineCellCount += Utils::SplitLine(line, ';').size();
+            begin = end + 1;
+        }
+    });
+    Utils::PrintInfo(fmt::format("Utils::SplitLine:   {:8.3f}s ({:8.1f} MB/s, {} cells)", splitLineTime,
+                                 megabytes / splitLineTime, splitLineCellCount));
+
+    size_t cellCount = 0;
+    std::vector<size_t> positions;
+    std::vector<std::string_view> cells;
+    CsvScanner scanner(';');
+    const double scannerTime = Measure([&] {
+        scanner.Scan(csv.data(), 0, csv.size(), positions);
+        size_t cellBegin = 0;
+        for (size_t position : positions)
+        {
+            cells.emplace_back(csv.data() + cellBegin, position - cellBegin);
+            cellBegin = position + 1;
+            if (csv[position] == '\n')
+            {
+                cellCount += cells.size();
+                cells.clear();
+            }
+        }
+    });
+    Utils::PrintInfo(fmt::format("CsvScanner ({}): {:8.3f}s ({:8.1f} MB/s, {} cells)",
+                                 CsvScanner::GetInstructionSet(), scannerTime, megabytes / scannerTime,
+                                 cellCount));
+    if (cellCount != splitLineCellCount)
+    {
+        throw InternalException(__FILE__, __LINE__,
+                                fmt::format("CsvScanner found {} of {} cells.", cellCount, splitLineCellCount));
+    }
+    Utils::PrintInfo(fmt::format("Speedup: {:.1f}x", splitLineTime / scannerTime));
+}
+
+void ChunkedParserBenchmark()
+{
+    const fs::path directory = fs::temp_directory_path() / "hokee-bench";
+    fs::create_directories(directory);
+    const fs::path formatFile = directory / "format.ini";
+    const fs::path csvFile = directory / "statement.csv";
+
+    WriteFormat(formatFile);
+    {
+        std::ofstream csv(csvFile, std::ios::binary);
+        csv << "\"Bank BENCH:\";\"Account 123\";\n\"date\";\"description\";\"payer/payee\";\"value\"\n";
+        const size_t batch = 100000;
+        const size_t size = _chunkedParserMegabytes * 1024 * 1024;
+        for (size_t line = 0; static_cast<size_t>(csv.tellp()) < size; line += batch)
+        {
+            csv << GenerateCsv(batch, line);
+        }
+    }
+    const double megabytes = static_cast<double>(fs::file_size(csvFile)) / (1024 * 1024);
+    Utils::PrintInfo(fmt::format("Generated {:.0f} MB in '{}'", megabytes, csvFile.string()));
+
+    CsvFormat format(formatFile);
+    double singleThreadTime = 0;
+    const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        size_t rows = 0;
+        const double time = Measure([&] {
+            CsvTable csvData;
+            CsvParser(csvFile, format).Load(csvData, threads);
+            rows = csvData.size();
+        });
+        singleThreadTime = threads == 1 ? time : singleThreadTime;
+        Utils::PrintInfo(fmt::format("{:3} threads: {:8.3f}s ({:8.1f} MB/s, {} rows, speedup {:.1f}x)", threads,
+                                     time, megabytes / time, rows, singleThreadTime / time));
+    }
+
+    fs::remove_all(directory);
+}
+
+void DatabaseMemoryBenchmark()
+{
+    const fs::path directory = fs::temp_directory_path() / "hokee-bench";
+    const fs::path inputDirectory = directory / "input";
+    const fs::path rulesFile = directory / "rules.csv";
+    fs::create_directories(inputDirectory / "BENCH");
+    WriteFormat(inputDirectory / "BENCH" / "format.ini");
+    {
+        std::ofstream csv(inputDirectory / "BENCH" / "statement.csv", std::ios::binary);
+        csv << "\"Bank BENCH:\";\"Account 123\";\n\"date\";\"description\";\"payer/payee\";\"value\"\n";
+        for (size_t line = 0; line < 1000000; line += 100000)
+        {
+            csv << GenerateCsv(100000, line);
+        }
+
+        std::ofstream rules(rulesFile, std::ios::binary);
+        rules << "Category;Payer/Payee;Description;Type;Date;Account;Value\n";
+        for (size_t i = 0; i < 100; ++i)
+        {
+            rules << fmt::format("Category {};supermarket {}$;;;;;\n", i % 10, i);
+        }
+    }
+
+    const size_t residentBefore = GetResidentBytes();
+    auto database = std::make_unique<CsvDatabase>();
+    const size_t heapAllocations = GetHeapAllocationCount();
+    const size_t arenaAllocations = CsvArena::GetTotalAllocationCount();
+    const size_t arenaBlocks = CsvArena::GetTotalBlockCount();
+    const size_t arenaBytes = CsvArena::GetTotalBlockBytes();
+    const double time = Measure([&] { database->Load(inputDirectory, rulesFile); });
+    const size_t resident = GetResidentBytes() - residentBefore;
+    const size_t rows = std::max<size_t>(1, database->Data.size());
+    Utils::PrintInfo(fmt::format("{} rows in {:.3f}s: resident memory {:.1f} MB ({} bytes per row)", rows, time,
+                                 static_cast<double>(resident) / (1024 * 1024), resident / rows));
+    const size_t allocations = GetHeapAllocationCount() - heapAllocations;
+    Utils::PrintInfo(fmt::format("sizeof(CsvItem) = {} bytes, {:.2f} heap allocations per row", sizeof(CsvItem),
+                                 static_cast<double>(allocations) / rows));
+    const double arenaMegabytes = static_cast<double>(CsvArena::GetTotalBlockBytes() - arenaBytes) / (1024 * 1024);
+    Utils::PrintInfo(fmt::format("Arenas: {} allocations in {} blocks ({:.1f} MB)",
+                                 CsvArena::GetTotalAllocationCount() - arenaAllocations,
+                                 CsvArena::GetTotalBlockCount() - arenaBlocks, arenaMegabytes));
+    const double freeTime = Measure([&] { database.reset(); });
+    Utils::PrintInfo(fmt::format("Free: {:.3f}s", freeTime));
+
+    fs::remove_all(directory);
+}
+
+void PatternBenchmark()
+{
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        texts.push_back(fmt::format("receipt {} for something at supermarket {}", i * 7919, i % 100));
+    }
+    const std::vector<std::string> patterns{"supermarket 42", "^receipt 7", "something at", "market 9$",
+                                            "receipt [0-9]+ for"};
+
+    for (const auto& pattern : patterns)
+    {
+        size_t regexMatches = 0;
+        const std::regex regex(pattern);
+        const double regexTime = Measure([&] {
+            for (const auto& text : texts)
+            {
+                regexMatches += std::regex_search(text, regex) ? 1 : 0;
+            }
+        });
+
+        size_t patternMatches = 0;
+        const CsvPattern csvPattern(pattern);
+        const double patternTime = Measure([&] {
+            for (const auto& text : texts)
+            {
+                patternMatches += csvPattern.Search(text) ? 1 : 0;
+            }
+        });
+
+        Utils::PrintInfo(fmt::format("{:20} regex {:8.4f}s, CsvPattern {:8.4f}s ({:5.1f}x, {} matches){}",
+                                     pattern, regexTime, patternTime, regexTime / patternTime, patternMatches,
+                                     regexMatches == patternMatches ? "" : " MISMATCH"));
+    }
+}
+
+void RuleFilterBenchmark()
+{
+    CsvPatternCache patterns;
+    CsvTable ruleItems;
+    std::vector<CsvRule> rules;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        const CsvRowShared& rule = ruleItems.AddItem();
+        rule->SetCategory(fmt::format("category {}", i % 50));
+        if (i % 4 == 0)
+        {
+            rule->SetPayerPayee(fmt::format("supermarket {}$", i));
+        }
+        else if (i % 4 == 1)
+        {
+            rule->SetDescription(fmt::format("receipt {}[0-9] for", i));
+        }
+        else
+        {
+            rule->SetDescription(fmt::format("contract {}", i));
+        }
+        rules.emplace_back(*rule, patterns);
+    }
+
+    CsvTable rows;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        const CsvRowShared& row = rows.AddItem();
+        row->SetPayerPayee(fmt::format("supermarket {}", i % 3000));
+        row->SetDescription(fmt::format("receipt {} for contract {}", i * 7, i % 2500));
+    }
+    const CsvColumns& columns = rows.GetColumns();
+
+    size_t allMatches = 0;
+    const double allTime = Measure([&] {
+        for (auto& row : rows)
+        {
+            for (auto& rule : rules)
+            {
+                allMatches += rule.Match(*row) ? 1 : 0;
+            }
+        }
+    });
+
+    size_t filterMatches = 0;
+    CsvRuleFilter filter;
+    const double filterTime = Measure([&] {
+        filter.Build(rules);
+        std::vector<size_t> candidates;
+        for (size_t r = 0; r < columns.GetSize(); ++r)
+        {
+            filter.GetCandidates(columns, r, candidates);
+            for (size_t candidate : candidates)
+            {
+                filterMatches += rules[candidate].Match(columns, r) ? 1 : 0;
+            }
+        }
+    });
+
+    Utils::PrintInfo(fmt::format("{} rows x {} rules", rows.size(), rules.size()));
+    Utils::PrintInfo(fmt::format("All rules: {:8.3f}s ({} matches)", allTime, allMatches));
+    Utils::PrintInfo(fmt::format("Filtered:  {:8.3f}s ({} matches)", filterTime, filterMatches));
+    Utils::PrintInfo(fmt::format("Speedup: {:.1f}x{}", allTime / filterTime,
+                                 allMatches == filterMatches ? "" : " MISMATCH"));
+}
+
+void ColumnScanBenchmark()
+{
+    CsvTable data;
+    for (size_t i = 0; i < 1000000; ++i)
+    {
+        const CsvRowShared& row = data.AddItem();
+        row->SetDate(CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.{}", i % 28 + 1, i % 12 + 1, 2010 + i % 10)));
+        row->SetValue(CsvValue(fmt::format("-{},{:02}", i % 1000, i % 100), "", 0));
+        row->SetCategory(fmt::format("category {}", i % 50));
+    }
+
+    const CsvColumns& columns = data.GetColumns();
+
+    // Same filter as items.html: year, month, category and sign of the value
+    const CsvSymbol category("category 7");
+    int64_t itemSum = 0;
+    const double itemTime = Measure([&] {
+        for (int month = 0; month <= 12; ++month)
+        {
+            for (auto& item : data)
+            {
+                if (item->GetDate().GetYear() == 2017 && (month == 0 || month == item->GetDate().GetMonth())
+                    && item->GetCategory() == category && item->GetValue().GetCents() < 0)
+                {
+                    itemSum += item->GetValue().GetCents();
+                }
+            }
+        }
+    });
+
+    int64_t columnSum = 0;
+    const double columnTime = Measure([&] {
+        for (int month = 0; month <= 12; ++month)
+        {
+            for (size_t r = 0; r < columns.GetSize(); ++r)
+            {
+                if (columns.GetYear(r) == 2017 && (month == 0 || month == columns.GetMonth(r))
+                    && columns.GetCategory(r) == category && columns.GetValue(r).GetCents() < 0)
+                {
+                    columnSum += columns.GetValue(r).GetCents();
+                }
+            }
+        }
+    });
+
+    const size_t columnBytes = sizeof(CsvDate) + sizeof(CsvValue) + sizeof(CsvSymbol);
+    Utils::PrintInfo(fmt::format("{} rows, CsvItem {} bytes, scanned columns {} bytes per row", data.size(),
+                                 sizeof(CsvItem), columnBytes));
+    Utils::PrintInfo(fmt::format("CsvItem scan: {:8.3f}s ({})", itemTime, CsvValue::FormatCents(itemSum)));
+    Utils::PrintInfo(fmt::format("Column scan:  {:8.3f}s ({})", columnTime, CsvValue::FormatCents(columnSum)));
+    Utils::PrintInfo(
+        fmt::format("Speedup: {:.1f}x{}", itemTime / columnTime, itemSum == columnSum ? "" : " MISMATCH"));
+}
+
+void DateParserBenchmark()
+{
+    std::vector<std::string> dates;
+    for (size_t i = 0; i < 1000000; ++i)
+    {
+        dates.push_back(fmt::format("{}-{:02}-{:02}", 2010 + i % 10, i % 12 + 1, i % 28 + 1));
+    }
+
+    // Format string resolved for every date vs. once
+    int64_t lookupSum = 0;
+    const double lookupTime = Measure([&] {
+        for (auto& date : dates)
+        {
+            lookupSum += CsvDate("yyyy-mm-dd", date).ToInt();
+        }
+    });
+
+    const CsvDate::Parser parser = CsvDate::GetParser("yyyy-mm-dd");
+    int64_t parserSum = 0;
+    const double parserTime = Measure([&] {
+        for (auto& date : dates)
+        {
+            parserSum += parser(date).ToInt();
+        }
+    });
+
+    Utils::PrintInfo(fmt::format("{} dates 'yyyy-mm-dd'", dates.size()));
+    Utils::PrintInfo(fmt::format("Format lookup: {:8.3f}s", lookupTime));
+    Utils::PrintInfo(fmt::format("Parser:        {:8.3f}s", parserTime));
+    Utils::PrintInfo(
+        fmt::format("Speedup: {:.1f}x{}", lookupTime / parserTime, lookupSum == parserSum ? "" : " MISMATCH"));
+}
+
+void SortBenchmark()
+{
+    for (size_t rowCount : {100000, 1000000, 10000000})
+    {
+        // Rows in the columns of the table, like after loading
+        CsvTable rows;
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            const CsvRowShared& row = rows.AddItem();
+            const size_t day = (i * 7919) % 3650;
+            const size_t month = day / 28 % 12 + 1;
+            const size_t year = 2010 + day % 10;
+            row->SetDate(CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.{}", day % 28 + 1, month, year)));
+        }
+
+        std::vector<CsvRowShared> compareRows = rows.GetRows();
+        const double compareTime = Measure([&] {
+            std::sort(compareRows.begin(), compareRows.end(),
+                      [](const CsvRowShared& i, const CsvRowShared& j) { return i->GetDate() < j->GetDate(); });
+        });
+        std::vector<CsvRowShared> stableRows = rows.GetRows();
+        const double stableTime = Measure([&] {
+            std::stable_sort(stableRows.begin(), stableRows.end(),
+                             [](const CsvRowShared& i, const CsvRowShared& j) { return i->GetDate() < j->GetDate(); });
+        });
+        const double radixTime = Measure([&] { CsvDatabase::Sort(rows); });
+
+        Utils::PrintInfo(fmt::format("{:9} rows: std::sort {:7.3f}s, std::stable_sort {:7.3f}s, radix {:7.3f}s "
+                                     "({:.1f}x){}",
+                                     rowCount, compareTime, stableTime, radixTime, compareTime / radixTime,
+                                     rows.GetRows() == stableRows ? "" : " MISMATCH"));
+    }
+}
+
+void MergeRunsBenchmark()
+{
+    // 20 statement files with 50000 rows each, half of them in descending order
+    std::vector<CsvTable> files(20);
+    for (size_t f = 0; f < files.size(); ++f)
+    {
+        for (size_t i = 0; i < 50000; ++i)
+        {
+            const CsvRowShared& row = files[f].AddItem();
+            const size_t day = (f % 2 == 0 ? i : 49999 - i) / 14;
+            const size_t year = 2010 + day / 336;
+            const size_t month = day / 28 % 12 + 1;
+            row->SetDate(CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.{}", day % 28 + 1, month, year)));
+            row->SetLine(static_cast<int>(f * 50000 + i));
+        }
+    }
+
+    // Both sort the rows together with their columns
+    CsvTable sorted;
+    for (auto& file : files)
+    {
+        for (auto& row : file)
+        {
+            sorted.AddItem(*row, row->Id);
+        }
+    }
+    const double sortTime = Measure([&] { CsvDatabase::Sort(sorted); });
+
+    CsvTable merged;
+    const double mergeTime = Measure([&] {
+        for (auto& file : files)
+        {
+            CsvDatabase::SortRun(file);
+        }
+        CsvDatabase::MergeRuns(files, merged);
+    });
+
+    Utils::PrintInfo(fmt::format("{} rows in 20 files", sorted.size()));
+    Utils::PrintInfo(fmt::format("Sort:  {:8.3f}s", sortTime));
+    Utils::PrintInfo(fmt::format("Merge: {:8.3f}s", mergeTime));
+    bool isSame = sorted.size() == merged.size();
+    for (size_t i = 0; isSame && i < sorted.size(); ++i)
+    {
+        isSame = sorted[i]->GetLine() == merged[i]->GetLine();
+    }
+    Utils::PrintInfo(fmt::format("Speedup: {:.1f}x{}", sortTime / mergeTime, isSame ? "" : " MISMATCH"));
+}
+
+void TableIndexBenchmark()
+{
+    CsvTable rows;
+    for (size_t i = 0; i < 1000000; ++i)
+    {
+        rows.AddItem(static_cast<int>((i * 7919) % 1000000 + 1));
+    }
+
+    // Lookups of an item page: find the item, previous and next id
+    auto scanThrough = [&rows](int64_t& checksum) {
+        for (int id = 1; id <= 1000000; id += 10000)
+        {
+            int prev = -1;
+            int next = -1;
+            for (auto& row : rows)
+            {
+                checksum += row->Id == id ? id : 0;
+                prev = row->Id < id && (prev == -1 || row->Id > prev) ? row->Id : prev;
+                next = row->Id > id && (next == -1 || row->Id < next) ? row->Id : next;
+            }
+            checksum += prev + next;
+        }
+    };
+    int64_t scanChecksum = 0;
+    const double scanTime = Measure([&] { scanThrough(scanChecksum); });
+
+    CsvTable table;
+    const double indexTime = Measure([&] { table.Append(std::vector<CsvRowShared>(rows.GetRows())); });
+    auto clickThrough = [&table](int64_t& checksum) {
+        for (int id = 1; id <= 1000000; id += 10000)
+        {
+            checksum += table.FindItem(id)->Id + table.PrevItem(id) + table.NextItem(id);
+        }
+    };
+    int64_t indexChecksum = 0;
+    const double lookupTime = Measure([&] { clickThrough(indexChecksum); });
+
+    Utils::PrintInfo(fmt::format("100 item pages in {} rows", table.size()));
+    Utils::PrintInfo(fmt::format("Scan:   {:8.4f}s", scanTime));
+    Utils::PrintInfo(fmt::format("Index:  {:8.4f}s (Append {:.3f}s)", lookupTime, indexTime));
+    Utils::PrintInfo(fmt::format("Speedup: {:.0f}x{}", scanTime / lookupTime,
+                                 scanChecksum == indexChecksum ? "" : " MISMATCH"));
+}
+
+void TextIndexBenchmark()
+{
+    CsvTable data;
+    std::vector<CsvSymbol> categories;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        categories.emplace_back(fmt::format("category {}", i));
+    }
+    for (size_t i = 0; i < 500000; ++i)
+    {
+        const CsvRowShared& row = data.AddItem();
+        row->SetPayerPayee(fmt::format("supermarket {}", i % 1000));
+        row->SetDescription(fmt::format("receipt {} for something", i * 7919));
+        row->SetType(i % 3 == 0 ? "direct debit" : "card payment");
+        row->SetAccount(fmt::format("de{:020}", i % 5));
+        row->SetCategory(categories[i % categories.size()]);
+    }
+
+    const CsvColumns& columns = data.GetColumns();
+    CsvTextIndex index;
+    const double buildTime = Measure([&] { index.Build(columns); });
+
+    // Queries typed into the filter box of a table page
+    const std::vector<std::string> queries{"supermarket 123", "RECEIPT 4711", "category 7 debit", "no such text"};
+    size_t scanMatches = 0;
+    const double scanTime = Measure([&] {
+        for (const auto& query : queries)
+        {
+            const std::vector<std::string> words = CsvTextIndex::SplitQuery(query);
+            for (const auto& row : data)
+            {
+                scanMatches += CsvTextIndex::Match(*row, words) ? 1 : 0;
+            }
+        }
+    });
+    size_t indexMatches = 0;
+    const double indexTime = Measure([&] {
+        for (const auto& query : queries)
+        {
+            indexMatches += index.Find(columns, categories, query).size();
+        }
+    });
+
+    Utils::PrintInfo(fmt::format("{} queries in {} rows, {} trigrams (build {:.3f}s)", queries.size(), data.size(),
+                                 index.GetTrigramCount(), buildTime));
+    Utils::PrintInfo(fmt::format("Scan:   {:8.4f}s ({} matches)", scanTime, scanMatches));
+    Utils::PrintInfo(fmt::format("Index:  {:8.4f}s ({} matches)", indexTime, indexMatches));
+    Utils::PrintInfo(fmt::format("Speedup: {:.0f}x{}", scanTime / indexTime,
+                                 scanMatches == indexMatches ? "" : " MISMATCH"));
+}
+
+void SummaryBenchmark()
+{
+    CsvTable data;
+    std::vector<CsvSymbol> categories{CsvSymbol()};
+    for (size_t i = 0; i < 50; ++i)
+    {
+        categories.emplace_back(fmt::format("category {}", i));
+    }
+    for (size_t i = 0; i < 1000000; ++i)
+    {
+        const CsvRowShared& row = data.AddItem();
+        row->SetDate(CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.{}", i % 28 + 1, i % 12 + 1, 2010 + i % 10)));
+        row->SetValue(CsvValue(fmt::format("-{},{:02}", i % 1000, i % 100), "", 0));
+        row->SetCategory(categories[1 + i % 50]);
+    }
+    const CsvColumns& columns = data.GetColumns();
+
+    // Cells of the summary page: sum, profit and expenses of every category, year and month
+    auto readCells = [&categories](const CsvSummary& summary, int64_t& checksum) {
+        for (const auto& category : categories)
+        {
+            for (int year = summary.GetMinYear(); year <= summary.GetMaxYear(); ++year)
+            {
+                for (int month = 0; month <= 12; ++month)
+                {
+                    const CsvSummary::Cell& cell = summary.GetCell(category, year, month);
+                    checksum += cell.Sum + cell.Income + cell.Expense;
+                }
+            }
+        }
+    };
+
+    // Before, every summary page summed up all rows
+    int64_t scanChecksum = 0;
+    const double scanTime = Measure([&] {
+        CsvSummary summary;
+        summary.Build(columns);
+        readCells(summary, scanChecksum);
+    });
+    CsvSummary summary;
+    summary.Build(columns);
+    int64_t cubeChecksum = 0;
+    const double cubeTime = Measure([&] { readCells(summary, cubeChecksum); });
+
+    // A rule change moves the items of one category
+    const double moveTime = Measure([&] {
+        for (size_t r = 0; r < columns.GetSize(); r += 50)
+        {
+            summary.Move(columns.GetYear(r), columns.GetMonth(r), columns.GetValue(r).GetCents(),
+                         columns.GetCategory(r), categories[2]);
+        }
+    });
+
+    Utils::PrintInfo(fmt::format("Summary page of {} rows, {} categories", data.size(), categories.size()));
+    Utils::PrintInfo(fmt::format("Sum up rows:  {:8.4f}s", scanTime));
+    Utils::PrintInfo(fmt::format("Read cells:   {:8.4f}s (move {} items {:.4f}s)", cubeTime,
+                                 columns.GetSize() / 50, moveTime));
+    Utils::PrintInfo(fmt::format("Speedup: {:.0f}x{}", scanTime / cubeTime,
+                                 scanChecksum == cubeChecksum ? "" : " MISMATCH"));
+}
+
+void HtmlPageBenchmark()
+{
+    CsvDatabase database;
+    for (size_t i = 0; i < 200000; ++i)
+    {
+        const CsvRowShared& row = database.Data.AddItem(static_cast<int>(i + 1));
+        row->SetPayerPayee(fmt::format("Supermarket {}", i % 1000));
+        row->SetDescription(fmt::format("receipt {} for something", i * 7919));
+        row->SetDate(CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.{}", i % 28 + 1, i % 12 + 1, 2010 + i % 10)));
+        row->SetValue(CsvValue(fmt::format("-{},{:02}", i % 1000, i % 100), "bench.csv", static_cast<int>(i)));
+    }
+
+    // The item table as HtmlGenerator built it before, one HtmlElement per tag and text
+    std::string domPage;
+    size_t heapAllocations = GetHeapAllocationCount();
+    const double domTime = Measure([&] {
+        HtmlElement html;
+        auto table = html.AddBody()->AddMain()->AddTable();
+        for (const auto& row : database.Data)
+        {
+            auto htmlRow = table->AddTableRow();
+            htmlRow->SetAttribute("class", "link unassigned");
+            htmlRow->SetAttribute("onclick", fmt::format("window.location='{}?id={}';", "item.html", row->Id));
+            htmlRow->AddTableCell(fmt::format("{}", row->Id));
+            htmlRow->AddTableCell("&nbsp;");
+            htmlRow->AddTableCell(std::string(row->GetPayerPayee()));
+            htmlRow->AddTableCell(std::string(row->GetDescription()));
+            htmlRow->AddTableCell("&nbsp;");
+            htmlRow->AddTableCell(row->GetDate().ToString());
+            htmlRow->AddTableCell("&nbsp;");
+            auto cell = htmlRow->AddTableCell(row->GetValue().ToString());
+            cell->SetAttribute("class", row->GetValue().GetCents() < 0 ? "neg" : "");
+        }
+        domPage = html.ToString();
+    });
+    const size_t domAllocations = GetHeapAllocationCount() - heapAllocations;
+
+    std::string page;
+    heapAllocations = GetHeapAllocationCount();
+    const double writerTime =
+        Measure([&] { page = HtmlGenerator::GetTablePage(database, "All items", database.Data, 0); });
+    const size_t writerAllocations = GetHeapAllocationCount() - heapAllocations;
+
+    Utils::PrintInfo(fmt::format("{} rows, {:.1f} MB", database.Data.size(),
+                                 static_cast<double>(page.size()) / (1024 * 1024)));
+    Utils::PrintInfo(fmt::format("HtmlElement: {:7.3f}s, {} heap allocations (table only)", domTime,
+                                 domAllocations));
+    Utils::PrintInfo(fmt::format("HtmlWriter:  {:7.3f}s, {} heap allocations", writerTime, writerAllocations));
+    const bool same = page.find(domPage.substr(domPage.find("<tr class"), 4096)) != std::string::npos;
+    Utils::PrintInfo(fmt::format("Speedup: {:.1f}x{}", domTime / writerTime, same ? "" : " MISMATCH"));
+}
+
+int main(int argc, const char* argv[])
+{
+    std::set_terminate(Utils::TerminationHandler);
+    try
+    {
+        Utils::PrintInfo(fmt::format("hokee-bench version {}", PROJECT_VERSION));
+        if (argc > 1)
+        {
+            // Size of the generated file for ChunkedParserBenchmark in MB
+            _chunkedParserMegabytes = std::strtoul(argv[1], nullptr, 10);
+        }
+
+        // First, so memory freed by the other benchmarks does not hide the allocations
+        runBenchmark("DatabaseMemoryBenchmark", DatabaseMemoryBenchmark);
+        runBenchmark("SplitLineBenchmark", SplitLineBenchmark);
+        runBenchmark("PatternBenchmark", PatternBenchmark);
+        runBenchmark("RuleFilterBenchmark", RuleFilterBenchmark);
+        runBenchmark("ColumnScanBenchmark", ColumnScanBenchmark);
+        runBenchmark("DateParserBenchmark", DateParserBenchmark);
+        runBenchmark("SortBenchmark", SortBenchmark);
+        runBenchmark("MergeRunsBenchmark", MergeRunsBenchmark);
+        runBenchmark("TableIndexBenchmark", TableIndexBenchmark);
+        runBenchmark("TextIndexBenchmark", TextIndexBenchmark);
+        runBenchmark("SummaryBenchmark", SummaryBenchmark);
+        runBenchmark("HtmlPageBenchmark", HtmlPageBenchmark);
+        runBenchmark("ChunkedParserBenchmark", ChunkedParserBenchmark);
+    }
+    catch (const UserException& e)
+    {
+        Utils::TerminationHandler(e);
+    }
+    catch (const std::exception& e)
+    {
+        Utils::TerminationHandler(e);
+    }
+    catch (...)
+    {
+        Utils::TerminationHandler();
+    }
+
+    return 0;
+}
\ No newline at end of file
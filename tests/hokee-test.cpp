@@ -1,14 +1,33 @@
+#include "AhoCorasick.h"
 #include "Application.h"
+#include "ThreadPool.h"
+#include "csv/CsvArena.h"
+#include "csv/CsvParser.h"
+#include "csv/CsvPattern.h"
+#include "csv/CsvRule.h"
+#include "csv/CsvRuleFilter.h"
+#include "csv/CsvScanner.h"
+#include "csv/CsvSummary.h"
+#include "csv/CsvSymbol.h"
+#include "csv/CsvTextIndex.h"
 #include "InternalException.h"
 #include "Utils.h"
 #include "hokee.h"
 #include "html/HtmlElement.h"
+#include "html/HtmlGenerator.h"
+#include "html/HtmlWriter.h"
 
 #include <fmt/format.h>
+#include <fmt/ranges.h>
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <random>
+#include <regex>
 #include <functional>
 
 using namespace hokee;
@@ -49,11 +68,11 @@ bool FormatTest()
     int64_t sum = 0;
     for (auto& rule : database->Data)
     {
-        sum += static_cast<int64_t>(rule->Value.ToDouble());
-        hashes[rule->Category] += static_cast<int64_t>(rule->Value.ToDouble());
-        hashes[rule->Category] *= rule->Date.GetYear();
-        hashes[rule->Category] /= rule->Date.GetMonth();
-        hashes[rule->Category] -= rule->Date.GetDay();
+        sum += static_cast<int64_t>(rule->GetValue().ToDouble());
+        hashes[rule->GetCategory().ToString()] += static_cast<int64_t>(rule->GetValue().ToDouble());
+        hashes[rule->GetCategory().ToString()] *= rule->GetDate().GetYear();
+        hashes[rule->GetCategory().ToString()] /= rule->GetDate().GetMonth();
+        hashes[rule->GetCategory().ToString()] -= rule->GetDate().GetDay();
     }
     int64_t hash = 1;
     for (auto& h : hashes)
@@ -161,6 +180,83 @@ bool HtmlTest()
     return Utils::CompareFiles(htmlPath, referencePath);
 }
 
+bool HtmlWriterTest()
+{
+    // Same document as HtmlTest
+    HtmlWriter html;
+    html.Open("head");
+    html.Element("title", "Title");
+    html.Element("meta", {}, {{"name", "html_test"}, {"content", "unit-test"}, {"charset", "UTF-8"}});
+    html.Element("link", {},
+                 {{"rel", "icon"},
+                  {"type", "image/jpg"},
+                  {"sizes", "32x32"},
+                  {"href", "https://www.fillmurray.com/32/32"}});
+    html.Close();
+
+    html.Open("body");
+    html.Open("header");
+    html.Element("h2", "Heading 2");
+    html.Close();
+
+    html.Open("main");
+    html.Open("div");
+    html.Open("table");
+    html.Open("tr");
+    html.Element("th", "Head 1");
+    html.Element("th", "Head 2");
+    html.Close();
+    html.Open("tr");
+    html.Open("td");
+    html.Text("AAA BBB");
+    html.Element("br");
+    html.EscapedText("CCC <escaped>");
+    html.Element("br");
+    html.EscapedText("DDD \"EEE\"");
+    html.Element("br");
+    html.Text("GGG.");
+    html.Close();
+    html.Open("td");
+    html.Image("https://www.fillmurray.com/200/250", "fillmurray", 200, 250);
+    html.Close();
+    html.Close();
+    html.Close();
+    html.Close();
+    html.Close();
+
+    html.Open("footer");
+    html.Open("p");
+    html.Element("b", "BOLD: ");
+    html.Element("a", "www.fillmurray.com",
+                 {{"href", "https://www.fillmurray.com"}, {"title", "Link to fillmurray.com"}});
+
+    fs::path htmlPath = Utils::GetTempDir() / "writer.html";
+    std::ofstream ofStream;
+    ofStream.open(htmlPath, std::ios::binary);
+    ofStream << html.Finish();
+    ofStream.close();
+
+    fs::path referencePath = fs::path("..") / "test_data" / "html_test" / "index.html";
+    if (!Utils::CompareFiles(htmlPath, referencePath))
+    {
+        return false;
+    }
+
+    HtmlWriter invalid;
+    invalid.Open("p");
+    invalid.Text("text");
+    try
+    {
+        invalid.Attribute("class", "late");
+    }
+    catch (const InternalException&)
+    {
+        return true;
+    }
+    Utils::PrintError("Attribute after the content of an element was not rejected");
+    return false;
+}
+
 bool RuleTest()
 {
     bool success = true;
@@ -179,11 +275,11 @@ bool RuleTest()
     int64_t sum = 0;
     for (auto& rule : database->Data)
     {
-        sum += static_cast<int64_t>(rule->Value.ToDouble());
-        hashes[rule->Category] += static_cast<int64_t>(rule->Value.ToDouble());
-        hashes[rule->Category] *= rule->Date.GetYear();
-        hashes[rule->Category] /= rule->Date.GetMonth();
-        hashes[rule->Category] -= rule->Date.GetDay();
+        sum += static_cast<int64_t>(rule->GetValue().ToDouble());
+        hashes[rule->GetCategory().ToString()] += static_cast<int64_t>(rule->GetValue().ToDouble());
+        hashes[rule->GetCategory().ToString()] *= rule->GetDate().GetYear();
+        hashes[rule->GetCategory().ToString()] /= rule->GetDate().GetMonth();
+        hashes[rule->GetCategory().ToString()] -= rule->GetDate().GetDay();
     }
     int64_t hash = 1;
     for (auto& h : hashes)
@@ -236,6 +332,1264 @@ bool RuleTest()
     return success;
 }
 
+bool ScannerTest()
+{
+    // Plain scalar reference of CsvScanner::Scan()
+    auto scan = [](std::string& buffer, size_t begin, std::vector<size_t>& positions)
+    {
+        for (size_t i = begin; i < buffer.size(); ++i)
+        {
+            const auto c = static_cast<unsigned char>(buffer[i]);
+            if ((c < 32 || c > 126) && c != '\n' && c != '\r' && c != '\0')
+            {
+                buffer[i] = '_';
+            }
+            if (buffer[i] == ';' || buffer[i] == '\n')
+            {
+                positions.push_back(i);
+            }
+        }
+    };
+
+    // Random bytes of every kind, and printable buffers with structural characters at the block boundaries
+    std::vector<std::string> buffers;
+    std::mt19937 random(42);
+    const std::string bytes = std::string("ab;\n\t\r\x7f\x80\xc3\xff ", 11) + '\0';
+    for (size_t length = 0; length <= 100; ++length)
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            std::string buffer(length, 'x');
+            for (auto& c : buffer)
+            {
+                c = bytes[random() % bytes.size()];
+            }
+            buffers.push_back(buffer);
+        }
+        for (size_t position : {15, 16, 31, 32, 47, 63, 64})
+        {
+            if (position < length)
+            {
+                std::string buffer(length, 'x');
+                buffer[position] = ';';
+                buffer[length - 1 - position] = '\n';
+                buffers.push_back(buffer);
+                buffer[length / 2] = '\t';
+                buffers.push_back(buffer);
+            }
+        }
+    }
+
+    for (auto instructionSet : CsvScanner::GetInstructionSets())
+    {
+        const CsvScanner scanner(';', instructionSet);
+        for (const std::string& buffer : buffers)
+        {
+            for (size_t begin : {size_t{0}, size_t{3}})
+            {
+                if (begin > buffer.size())
+                {
+                    continue;
+                }
+                std::string expected = buffer;
+                std::vector<size_t> expectedPositions{};
+                scan(expected, begin, expectedPositions);
+                std::string actual = buffer;
+                std::vector<size_t> positions{};
+                scanner.Scan(actual.data(), begin, actual.size(), positions);
+                if (actual != expected || positions != expectedPositions)
+                {
+                    Utils::PrintError(fmt::format("{} scan of {} bytes from {} differs from the reference!",
+                                                  CsvScanner::GetName(instructionSet), buffer.size(), begin));
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool ChunkedParserTest()
+{
+    bool success = true;
+    fs::path inputPath = fs::path("..") / "test_data" / "input1" / "ABC";
+    CsvFormat format(inputPath / "format.ini");
+
+    CsvTable expected;
+    CsvParser(inputPath / "Account_123456790_2020_1.csv", format).Load(expected, 1);
+
+    // Tiny chunks to split the small test file, one chunk per thread of a private pool
+    ThreadPool threadPool(4);
+    CsvTable chunked;
+    CsvParser(inputPath / "Account_123456790_2020_1.csv", format, threadPool).Load(chunked, 0, 64);
+
+    if (chunked.size() != expected.size() || chunked.GetCsvHeader() != expected.GetCsvHeader())
+    {
+        Utils::PrintError(fmt::format("Chunked parser found {} items instead of {} !", chunked.size(),
+                                      expected.size()));
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        if (chunked[i]->GetLine() != expected[i]->GetLine()
+            || chunked[i]->GetDescription() != expected[i]->GetDescription()
+            || chunked[i]->GetValue().ToDouble() != expected[i]->GetValue().ToDouble()
+            || chunked[i]->GetDate() != expected[i]->GetDate())
+        {
+            Utils::PrintError(fmt::format("Chunked parser item {} (line {}) does not match line {} !", i,
+                                          chunked[i]->GetLine(), expected[i]->GetLine()));
+            success = false;
+        }
+    }
+    return success;
+}
+
+std::string GetDatabaseState(const CsvDatabase& database)
+{
+    std::string state;
+    const CsvColumns& columns = database.Data.GetColumns();
+    for (size_t r = 0; r < database.Data.size(); ++r)
+    {
+        auto& row = database.Data[r];
+        state += fmt::format("{}:{}:{}:{}-{}:{}:", row->Id, row->GetCategory().ToString(),
+                             columns.GetCategory(r).ToString(), columns.GetYear(r), columns.GetMonth(r),
+                             columns.GetValue(r).GetCents());
+        for (auto& ref : row->References)
+        {
+            state += fmt::format("{},", ref->Id);
+        }
+        state += fmt::format("{}\n", row->Issues.size());
+    }
+    for (auto& rule : database.Rules)
+    {
+        std::vector<int> refs;
+        for (auto& ref : rule->References)
+        {
+            refs.push_back(ref->Id);
+        }
+        std::sort(refs.begin(), refs.end());
+        state += fmt::format("{}:{}:{}:{}\n", rule->Id, rule->GetCategory().ToString(), fmt::join(refs, ","),
+                             fmt::join(rule->Issues, ","));
+    }
+    for (auto& issue : database.Issues)
+    {
+        state += fmt::format("{},", issue->Id);
+    }
+    state += "\n";
+    for (auto& row : database.Assigned)
+    {
+        state += fmt::format("{},", row->Id);
+    }
+    state += "\n";
+    for (auto& row : database.Unassigned)
+    {
+        state += fmt::format("{},", row->Id);
+    }
+    return state;
+}
+
+bool IncrementalRuleTest()
+{
+    bool success = true;
+    Settings config;
+    std::string configPath = "../test_data/settings.ini";
+    config.SetRuleSetFile("rules.csv");
+    config.SetInputDirectory("input1");
+    config.Save(configPath);
+    const char* testArgv[] = {"hokee", configPath.c_str(), nullptr};
+    int testArgc = sizeof(testArgv) / sizeof(testArgv[0]) - 1;
+    auto app = std::make_unique<Application>(testArgc, testArgv);
+    std::unique_ptr<CsvDatabase> database = app->RunBatch();
+
+    auto compare = [&](const std::string& step) {
+        const std::string incremental = GetDatabaseState(*database);
+        database->MatchRules();
+        if (incremental != GetDatabaseState(*database))
+        {
+            Utils::PrintError(fmt::format("Incremental update '{}' does not match MatchRules() !", step));
+            success = false;
+        }
+    };
+
+    // Edit rule
+    auto rule = database->Rules[0];
+    rule->SetDescription("");
+    rule->SetPayerPayee("supermarket");
+    database->MatchRule(rule->Id);
+    compare("edit");
+
+    // Edit only the category of a rule
+    rule->SetCategory("Other");
+    database->MatchRule(rule->Id);
+    compare("category");
+
+    // New rule
+    auto unassigned = database->Unassigned[0];
+    const int newId = database->NewRule(unassigned->Id);
+    database->MatchRule(newId);
+    compare("new");
+
+    // Delete rules
+    database->DeleteRule(database->Rules[1]->Id);
+    compare("delete");
+    database->DeleteRule(newId);
+    compare("delete new");
+
+    return success;
+}
+
+bool ThreadPoolTest()
+{
+    bool success = true;
+    ThreadPool threadPool(4);
+
+    // Nested parallel loops
+    std::atomic<uint64_t> sum{0};
+    threadPool.ParallelFor("Outer", 100, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            threadPool.ParallelFor("", 1000, [&](size_t b, size_t e) {
+                for (size_t j = b; j < e; ++j)
+                {
+                    sum += i * 1000 + j;
+                }
+            });
+        }
+    });
+    const uint64_t expectedSum = 100000ull * 99999ull / 2;
+    if (sum != expectedSum)
+    {
+        Utils::PrintError(fmt::format("Computed sum {} does not match expected sum {} !", sum, expectedSum));
+        success = false;
+    }
+
+    // Exceptions are passed to the caller
+    try
+    {
+        threadPool.ParallelFor("", 100, [](size_t begin, size_t /*unused*/) {
+            if (begin == 50)
+            {
+                throw std::runtime_error("chunk 50");
+            }
+        }, 1);
+        Utils::PrintError("ParallelFor did not rethrow exception!");
+        success = false;
+    }
+    catch (const std::runtime_error& e)
+    {
+        if (std::string(e.what()) != "chunk 50")
+        {
+            Utils::PrintError(fmt::format("ParallelFor rethrew unexpected exception '{}'!", e.what()));
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool MatchStressTest()
+{
+    bool success = true;
+    ThreadPool threadPool(16);
+    CsvDatabase database(threadPool);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const CsvRowShared& row = database.Data.AddItem(i + 1);
+        row->SetDescription(fmt::format("Receipt {} Shop {}", i, i % 97));
+        row->SetPayerPayee(fmt::format("Payee {}", i % 13));
+    }
+    for (int r = 0; r < 300; ++r)
+    {
+        const CsvRowShared& rule = database.Rules.AddItem(100000 + r);
+        rule->SetCategory(fmt::format("Category {}", r % 7));
+        if (r % 3 == 0)
+        {
+            rule->SetDescription(fmt::format("shop {}", r % 97));
+        }
+        else if (r % 3 == 1)
+        {
+            rule->SetDescription(fmt::format("receipt [0-9]*{} ", r % 10));
+        }
+        else
+        {
+            rule->SetPayerPayee(fmt::format("payee {}$", r % 13));
+        }
+    }
+
+    database.MatchRules();
+
+    // Compare with sequential matching
+    CsvPatternCache patterns;
+    std::vector<CsvRule> rules;
+    for (auto& rule : database.Rules)
+    {
+        rules.emplace_back(*rule, patterns);
+    }
+    std::map<const CsvItem*, std::vector<const CsvItem*>> ruleReferences;
+    for (auto& row : database.Data)
+    {
+        std::vector<const CsvItem*> references;
+        for (auto& rule : rules)
+        {
+            if (rule.Match(*row))
+            {
+                references.push_back(&rule.GetItem());
+                ruleReferences[&rule.GetItem()].push_back(row.get());
+            }
+        }
+        if (!std::equal(references.begin(), references.end(), row->References.begin(), row->References.end())
+            || (!references.empty() && row->GetCategory() != references.back()->GetCategory()))
+        {
+            Utils::PrintError(fmt::format("Matches of row {} differ from sequential matching!", row->Id));
+            success = false;
+        }
+    }
+    for (auto& rule : database.Rules)
+    {
+        const auto& references = ruleReferences[rule.get()];
+        if (!std::equal(references.begin(), references.end(), rule->References.begin(), rule->References.end()))
+        {
+            Utils::PrintError(fmt::format("Matches of rule {} differ from sequential matching!", rule->Id));
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool SymbolTest()
+{
+    bool success = true;
+    const CsvSymbol a("Symbol Test A");
+    const CsvSymbol b(std::string("Symbol Test A"));
+    if (a != b || a.GetId() != b.GetId() || &a.ToString() != &b.ToString() || a.ToString() != "Symbol Test A")
+    {
+        Utils::PrintError("Equal strings are not interned as one symbol!");
+        success = false;
+    }
+    if (a.ToLower() != CsvSymbol("symbol test a") || a.ToLower().ToLower() != a.ToLower())
+    {
+        Utils::PrintError("ToLower() does not return the lower case symbol!");
+        success = false;
+    }
+    if (!CsvSymbol().IsEmpty() || CsvSymbol("").GetId() != 0 || a.IsEmpty())
+    {
+        Utils::PrintError("Empty symbol is not id 0!");
+        success = false;
+    }
+    CsvSymbol found;
+    if (!CsvSymbol::Find("Symbol Test A", found) || found != a || CsvSymbol::Find("Symbol Test Unknown", found))
+    {
+        Utils::PrintError("Find() does not return interned symbols only!");
+        success = false;
+    }
+
+    // Concurrent interning of the same strings yields one symbol per string
+    ThreadPool threadPool(8);
+    std::vector<std::vector<CsvSymbol>> symbols(64);
+    threadPool.ParallelFor("", symbols.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (int s = 0; s < 500; ++s)
+            {
+                symbols[i].emplace_back(fmt::format("Concurrent Symbol {}", s));
+            }
+        }
+    }, 1);
+    for (auto& threadSymbols : symbols)
+    {
+        if (threadSymbols != symbols[0])
+        {
+            Utils::PrintError("Concurrently interned symbols differ!");
+            success = false;
+            break;
+        }
+    }
+    return success;
+}
+
+bool ArenaTest()
+{
+    bool success = true;
+    CsvTable table;
+    for (int i = 0; i < 10000; ++i)
+    {
+        const CsvRowShared& row = table.AddItem(i);
+        row->SetDescription(fmt::format("Arena row {} with a description longer than the small string buffer", i));
+        if (reinterpret_cast<uintptr_t>(row.get()) % alignof(CsvItem) != 0)
+        {
+            Utils::PrintError("Arena returned unaligned memory!");
+            success = false;
+        }
+    }
+    // The item and the bytes of its description
+    std::shared_ptr<CsvArena> arena = table.GetColumns().GetArena();
+    if (arena->GetAllocationCount() != 2 * table.size() || arena->GetBlockCount() > 16)
+    {
+        Utils::PrintError(fmt::format("Unexpected arena counters: {} allocations in {} blocks!",
+                                      arena->GetAllocationCount(), arena->GetBlockCount()));
+        success = false;
+    }
+
+    // Moved rows keep their text in the arena of the other table
+    CsvTable merged;
+    merged.AddItem(-1);
+    merged.Append(std::move(table));
+    if (merged.GetColumns().GetArena() == arena || merged[1]->GetDescription().substr(0, 12) != "Arena row 0 ")
+    {
+        Utils::PrintError("Text of moved rows is wrong!");
+        success = false;
+    }
+
+    // Rows keep the arena alive
+    std::vector<CsvRowShared> rows(merged.begin() + 1, merged.end());
+    merged.Clear();
+    std::weak_ptr<CsvArena> weakArena = arena;
+    arena.reset();
+    for (int i = 0; i < static_cast<int>(rows.size()); ++i)
+    {
+        if (rows[i]->Id != i || weakArena.expired())
+        {
+            Utils::PrintError("Arena was released while rows were still in use!");
+            return false;
+        }
+    }
+    rows.clear();
+    if (!weakArena.expired())
+    {
+        Utils::PrintError("Arena was not released with its last row!");
+        success = false;
+    }
+    return success;
+}
+
+bool ValueTest()
+{
+    bool success = true;
+    const std::vector<std::pair<std::string, std::string>> values = {
+        {"", ""},
+        {"0", "0.00"},
+        {"-720,00", "-720.00"},
+        {"1.234,5", "1234.50"},
+        {"1,234.56", "1234.56"},
+        {"-1 234_5", "-12345.00"},
+        {"+3,1", "3.10"},
+        {".05", "0.05"}};
+    for (const auto& [text, expected] : values)
+    {
+        const CsvValue value(text, "", 0);
+        if (value.ToString() != expected || value.IsEmpty() != text.empty())
+        {
+            Utils::PrintError(
+                fmt::format("CsvValue('{}') is '{}' instead of '{}'!", text, value.ToString(), expected));
+            success = false;
+        }
+    }
+    if (CsvValue("-12,34", "", 0).GetCents() != -1234 || CsvValue("-12,34", "", 0).ToDouble() != -12.34
+        || CsvValue("0,125", "", 0, false).GetCents() != 13)
+    {
+        Utils::PrintError("CsvValue does not convert to cents!");
+        success = false;
+    }
+    if (CsvValue("0", "", 0) == CsvValue() || CsvValue("1,00", "", 0) != CsvValue("1", "", 0))
+    {
+        Utils::PrintError("CsvValue comparison is wrong!");
+        success = false;
+    }
+    for (const std::string text : {"12a", "1.2.3", "-", ",", "1-"})
+    {
+        try
+        {
+            CsvValue(text, "", 0, false);
+            Utils::PrintError(fmt::format("CsvValue('{}') was not rejected!", text));
+            success = false;
+        }
+        catch (const UserException&)
+        {
+        }
+    }
+    // Errors in statement files report file and line
+    for (const std::string text : {"1,234,567", "12,34 EUR"})
+    {
+        try
+        {
+            CsvValue(text, "statement.csv", 7);
+            Utils::PrintError(fmt::format("CsvValue('{}') was not rejected!", text));
+            success = false;
+        }
+        catch (const UserException& e)
+        {
+            if (e.GetFile() != "statement.csv" || e.GetLine() != 7)
+            {
+                Utils::PrintError(fmt::format("CsvValue('{}') error has no file and line!", text));
+                success = false;
+            }
+        }
+    }
+    try
+    {
+        CsvValue("1.234", "", 0);
+        Utils::PrintError("CsvValue with three decimal places was not rejected!");
+        success = false;
+    }
+    catch (const UserException&)
+    {
+    }
+    return success;
+}
+
+bool DateTest()
+{
+    bool success = true;
+    const CsvDate date("dd.mm.yyyy", "03.02.2021");
+    const CsvDate shortDate("dd.mm.yy", "03.02.21");
+    if (date.GetYear() != 2021 || date.GetMonth() != 2 || date.GetDay() != 3 || date.ToInt() != 20210203
+        || date != shortDate || date.ToString() != "03.02.2021" || shortDate.ToString() != "03.02.2021"
+        || shortDate.GetFormat() != "dd.mm.yy" || CsvDate("dd.mm.yy", "31.12.70").GetYear() != 1970)
+    {
+        Utils::PrintError(fmt::format("Date was not parsed correctly: {} ({})", date.ToString(), date.ToInt()));
+        success = false;
+    }
+    for (const auto& [format, dateStr] : std::vector<std::pair<std::string, std::string>>{
+             {"yyyy-mm-dd", "2021-02-03"}, {"mm/dd/yyyy", "02/03/2021"}, {"dd/mm/yyyy", "03/02/2021"},
+             {"yyyymmdd", "20210203"}})
+    {
+        const CsvDate parsed = CsvDate::GetParser(format)(dateStr);
+        if (parsed != date || parsed.GetFormat() != format || CsvDate(format, dateStr) != date)
+        {
+            Utils::PrintError(fmt::format("Date '{}' was not parsed as '{}'!", dateStr, format));
+            success = false;
+        }
+    }
+    const CsvDate empty("dd.mm.yyyy", "");
+    if (!empty.IsEmpty() || empty.GetYear() != -1 || empty.ToString() != "" || !(empty < date)
+        || !(CsvDate("dd.mm.yyyy", "31.12.2020") < date) || !(date < CsvDate("dd.mm.yyyy", "01.03.2021")))
+    {
+        Utils::PrintError("Dates are not ordered by year, month and day!");
+        success = false;
+    }
+    for (const std::string dateStr : {"3.2.2021", "03.02.20x1", "03.13.2021", "00.02.2021", "03/02/2021"})
+    {
+        try
+        {
+            CsvDate("dd.mm.yyyy", dateStr);
+            Utils::PrintError(fmt::format("Date '{}' was not rejected!", dateStr));
+            success = false;
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+    }
+    try
+    {
+        CsvDate::GetParser("yyyy.dd.mm");
+        Utils::PrintError("Unsupported date format was not rejected!");
+        success = false;
+    }
+    catch (const UserException&)
+    {
+    }
+    return success;
+}
+
+bool SortTest()
+{
+    CsvTable rows;
+    rows.SetCsvHeader({"Date"});
+    for (int i = 0; i < 5000; ++i)
+    {
+        const CsvRowShared& row = rows.AddItem(i);
+        // Dates across several years in shuffled order, many rows per day, some without a date
+        const int day = (i * 7919) % 1000;
+        if (day % 97 != 0)
+        {
+            row->SetDate(
+                CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.{}", day % 28 + 1, day % 12 + 1, 1990 + day % 40)));
+        }
+    }
+    std::vector<CsvRowShared> expected = rows.GetRows();
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const CsvRowShared& a, const CsvRowShared& b) { return a->GetDate() < b->GetDate(); });
+
+    CsvDatabase::Sort(rows);
+    if (rows.size() != expected.size() || !std::equal(rows.begin(), rows.end(), expected.begin())
+        || rows.GetCsvHeader().size() != 1)
+    {
+        Utils::PrintError("Sort is not a stable sort by date!");
+        return false;
+    }
+    return true;
+}
+
+bool MergeRunsTest()
+{
+    // Ascending, descending and unsorted runs with several rows per day, and an empty run
+    std::vector<CsvTable> runs(4);
+    int id = 0;
+    for (int i = 0; i < 300; ++i)
+    {
+        for (size_t r = 0; r < 3; ++r)
+        {
+            const int day = r == 0 ? i / 3 : r == 1 ? 99 - i / 4 : (i * 37) % 100;
+            const CsvRowShared& row = runs[r].AddItem(++id);
+            row->SetDate(CsvDate("dd.mm.yyyy", fmt::format("{:02}.{:02}.2020", day % 28 + 1, day / 28 + 1)));
+        }
+    }
+    CsvTable expected;
+    for (auto& run : runs)
+    {
+        expected.Append(std::vector<CsvRowShared>(run.begin(), run.end()));
+    }
+    CsvDatabase::Sort(expected);
+
+    CsvTable merged;
+    for (auto& run : runs)
+    {
+        CsvDatabase::SortRun(run);
+    }
+    CsvDatabase::MergeRuns(runs, merged);
+    if (merged.size() != expected.size() || !std::equal(merged.begin(), merged.end(), expected.begin()))
+    {
+        Utils::PrintError("Merged runs differ from the sorted table!");
+        return false;
+    }
+    return true;
+}
+
+bool TableIndexTest()
+{
+    bool success = true;
+    CsvTable table;
+    std::vector<CsvRowShared> rows;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto row = std::make_shared<CsvItem>();
+        row->Id = (i * 7919) % 1000 * 3 + 10;
+        rows.push_back(row);
+    }
+    table.Append(std::vector<CsvRowShared>(rows));
+
+    // Lookups agree with a scan of the rows, also for ids which are not in the table
+    auto check = [&](const std::string& step) {
+        for (int id = 0; id < 3100; ++id)
+        {
+            CsvRowShared item = nullptr;
+            int next = -1;
+            int prev = -1;
+            for (auto& row : rows)
+            {
+                item = row->Id == id ? row : item;
+                next = row->Id > id && (next == -1 || row->Id < next) ? row->Id : next;
+                prev = row->Id < id && (prev == -1 || row->Id > prev) ? row->Id : prev;
+            }
+            if (table.HasItem(id) != (item != nullptr) || table.FindItem(id) != item || table.NextItem(id) != next
+                || table.PrevItem(id) != prev)
+            {
+                Utils::PrintError(fmt::format("Lookup of id {} after {} differs from the scan!", id, step));
+                return false;
+            }
+        }
+        for (size_t i = 0; i < table.size(); ++i)
+        {
+            if (table.FindPosition(table[i]->Id) != i)
+            {
+                Utils::PrintError(fmt::format("Stale position of id {} after {}!", table[i]->Id, step));
+                return false;
+            }
+        }
+        return true;
+    };
+    success = check("Append()") && success;
+
+    // Deleting returns the next item and moves the following rows
+    const size_t position = table.FindPosition(13);
+    const int next = table[position + 1]->Id;
+    rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(position));
+    if (table.DeleteItem(13) != next || table.DeleteItem(13) != -1)
+    {
+        Utils::PrintError("DeleteItem() did not return the next item!");
+        success = false;
+    }
+    success = check("DeleteItem()") && success;
+
+    auto row = std::make_shared<CsvItem>();
+    row->Id = 11;
+    rows.push_back(row);
+    table.Add(row);
+    success = check("Add()") && success;
+
+    std::vector<size_t> order(table.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = order.size() - 1 - i;
+    }
+    std::reverse(rows.begin(), rows.end());
+    table.Reorder(order);
+    success = check("Reorder()") && success;
+
+    const int last = rows.back()->Id;
+    if (table.DeleteItem(last) != table.PrevItem(last))
+    {
+        Utils::PrintError("DeleteItem() of the last row did not return the item with the previous id!");
+        success = false;
+    }
+    rows.pop_back();
+    success = check("DeleteItem() of the last row") && success;
+
+    table.Clear();
+    rows.clear();
+    success = check("Clear()") && success;
+    return success;
+}
+
+bool TableViewTest()
+{
+    bool success = true;
+    CsvTable data;
+    for (int i = 0; i < 3; ++i)
+    {
+        data.AddItem(i);
+    }
+
+    // A view has no columns, also while it is empty
+    CsvTable view;
+    view.Append(std::vector<CsvRowShared>{});
+    auto rejects = [](const std::function<void()>& callback)
+    {
+        try
+        {
+            callback();
+        }
+        catch (const InternalException&)
+        {
+            return true;
+        }
+        return false;
+    };
+    if (!data.OwnsRows() || view.OwnsRows() || !rejects([&] { view.GetColumns(); })
+        || !rejects([&] { view.AddItem(3); }))
+    {
+        Utils::PrintError("Empty view was used like a table with columns!");
+        success = false;
+    }
+
+    // Reordering and deleting rows of a view does not change the columns of their table
+    view.Append(std::vector<CsvRowShared>(data.begin(), data.end()));
+    view.Reorder({2, 1, 0});
+    view.DeleteItem(1);
+    if (view.size() != 2 || view[0]->GetRow() != 2 || view[1]->GetRow() != 0
+        || data.GetColumns().GetSize() != 3)
+    {
+        Utils::PrintError("View changed the columns of its rows!");
+        success = false;
+    }
+
+    view.Clear();
+    if (!view.OwnsRows() || view.AddItem(3)->GetRow() != 0)
+    {
+        Utils::PrintError("Cleared view does not own its rows!");
+        success = false;
+    }
+
+    // Deleted rows of a table with columns keep their fields, the other rows move up
+    CsvTable table;
+    std::vector<CsvRowShared> rows;
+    for (int i = 0; i < 10; ++i)
+    {
+        rows.push_back(table.AddItem(i));
+        rows.back()->SetDescription(fmt::format("Row {}", i));
+    }
+    table.DeleteItems({9, 1, 42, 4, 1});
+    for (int i = 0; i < 10; ++i)
+    {
+        const bool isDeleted = i == 1 || i == 4 || i == 9;
+        const CsvItem& row = *rows[static_cast<size_t>(i)];
+        if (row.GetDescription() != fmt::format("Row {}", i) || table.HasItem(i) == isDeleted
+            || (!isDeleted && (table[row.GetRow()].get() != &row || &row.GetColumns() != &table.GetColumns()))
+            || (isDeleted && &rows[1]->GetColumns() != &row.GetColumns()))
+        {
+            Utils::PrintError(fmt::format("Row {} is wrong after DeleteItems()!", i));
+            success = false;
+        }
+    }
+    if (table.size() != 7 || table.GetColumns().GetSize() != 7 || table[3]->Id != 5)
+    {
+        Utils::PrintError("DeleteItems() did not compact the columns!");
+        success = false;
+    }
+    return success;
+}
+
+bool TablePageChunkTest()
+{
+    CsvDatabase database;
+    for (int i = 0; i < 2500; ++i)
+    {
+        const CsvRowShared& row = database.Data.AddItem(i);
+        row->SetPayerPayee(fmt::format("Payee {}", i));
+    }
+    const std::string page = HtmlGenerator::GetTablePage(database, "All items", database.Data, 0);
+
+    // Rows written and flushed in chunks, like HttpServer sends them
+    HtmlWriter html;
+    HtmlGenerator::BeginTablePage(html, database, "All items", 0, database.Data.size());
+    std::string chunkedPage = html.Flush();
+    for (size_t begin = 0; begin < database.Data.size(); begin += 1000)
+    {
+        HtmlGenerator::AddTableRows(html, database.Data.GetRows(), begin, begin + 1000);
+        chunkedPage += html.Flush();
+    }
+    HtmlGenerator::EndTablePage(html);
+    chunkedPage += html.Finish();
+
+    if (chunkedPage != page)
+    {
+        Utils::PrintError("Chunked table page differs from GetTablePage()!");
+        return false;
+    }
+    return true;
+}
+
+bool TablePageWindowTest()
+{
+    bool success = true;
+    CsvDatabase database;
+    for (int i = 0; i < 2500; ++i)
+    {
+        const CsvRowShared& row = database.Data.AddItem(i);
+        row->SetPayerPayee(fmt::format("Payee \"{}\"", i));
+    }
+
+    HtmlTableWindow window{"all.html", "all.json", 1000, 1000};
+    const std::string page = HtmlGenerator::GetTablePage(database, "All items", database.Data, 0, window);
+    for (const char* expected :
+         {"1001&nbsp;-&nbsp;2000&nbsp;/&nbsp;2500", "href=\"all.html?offset=0&amp;limit=1000\"",
+          "href=\"all.html?offset=2000&amp;limit=1000\"", "data-rows=\"all.json\"", "data-offset=\"2000\"",
+          "?id=1000'", "?id=1999'", "scrollTable.js"})
+    {
+        if (page.find(expected) == std::string::npos)
+        {
+            Utils::PrintError(fmt::format("Table page window does not contain '{}'!", expected));
+            success = false;
+        }
+    }
+    if (page.find("?id=999'") != std::string::npos || page.find("?id=2000'") != std::string::npos)
+    {
+        Utils::PrintError("Table page window contains rows outside of the window!");
+        success = false;
+    }
+
+    const std::string json = HtmlGenerator::GetTableRows(database.Data.GetRows(), 2400, 1000);
+    const std::string first = "{\"count\":2500,\"offset\":2400,\"rows\":"
+                              "[{\"id\":2400,\"class\":\"link unassigned\",\"cells\":[\"\",\"Payee \\\"2400\\\"\",";
+    if (json.compare(0, first.size(), first) != 0 || json.find("\"id\":2499,") == std::string::npos
+        || json.find("\"id\":2500,") != std::string::npos || json.substr(json.size() - 3) != "}]}")
+    {
+        Utils::PrintError(fmt::format("Unexpected JSON rows: {}...", json.substr(0, 200)));
+        success = false;
+    }
+
+    // Windows up to the end of the size_t range do not overflow
+    HtmlTableWindow last{"all.html", "all.json", 2000, SIZE_MAX};
+    const std::string lastPage = HtmlGenerator::GetTablePage(database, "All items", database.Data, 0, last);
+    const std::string noRows = HtmlGenerator::GetTableRows(database.Data.GetRows(), SIZE_MAX, SIZE_MAX);
+    if (lastPage.find("2001&nbsp;-&nbsp;2500&nbsp;/&nbsp;2500") == std::string::npos
+        || lastPage.find("data-offset=\"2500\"") == std::string::npos || lastPage.find("?id=2499'") == std::string::npos
+        || noRows.find("\"rows\":[]") == std::string::npos)
+    {
+        Utils::PrintError("Table page window with the largest limit is wrong!");
+        success = false;
+    }
+    return success;
+}
+
+bool TextIndexTest()
+{
+    bool success = true;
+    Settings config;
+    std::string configPath = "../test_data/settings.ini";
+    config.SetRuleSetFile("rules.csv");
+    config.SetInputDirectory("input1");
+    config.Save(configPath);
+    const char* testArgv[] = {"hokee", configPath.c_str(), nullptr};
+    int testArgc = sizeof(testArgv) / sizeof(testArgv[0]) - 1;
+    auto app = std::make_unique<Application>(testArgc, testArgv);
+    std::unique_ptr<CsvDatabase> database = app->RunBatch();
+
+    // Indexed search must return the same rows as a scan of the table
+    auto compare = [&](const std::string& name, const CsvTable& table, const std::string& query) {
+        const std::vector<std::string> words = CsvTextIndex::SplitQuery(query);
+        std::vector<int> expected;
+        for (const auto& row : table)
+        {
+            if (CsvTextIndex::Match(*row, words))
+            {
+                expected.push_back(row->Id);
+            }
+        }
+        std::vector<int> actual;
+        for (const auto& row : database->Search(table.GetRows(), query))
+        {
+            actual.push_back(row->Id);
+        }
+        if (actual != expected)
+        {
+            Utils::PrintError(fmt::format("Search '{}' in {} returned {} instead of {} rows!", query, name,
+                                          actual.size(), expected.size()));
+            success = false;
+        }
+        return expected.size();
+    };
+
+    const std::string category = database->Rules[0]->GetCategory().ToString();
+    for (const std::string& query : {std::string("super"), std::string("MARKET"), std::string("a e"),
+                                     std::string(" 1  "), std::string("no such text"), category,
+                                     category.substr(0, 3) + " a"})
+    {
+        compare("Data", database->Data, query);
+        compare("Assigned", database->Assigned, query);
+        compare("Unassigned", database->Unassigned, query);
+        compare("Rules", database->Rules, query);
+    }
+    if (compare("Data", database->Data, category) == 0)
+    {
+        Utils::PrintError(fmt::format("Search '{}' did not find the category!", category));
+        success = false;
+    }
+
+    // Categories are not indexed, so they are found right after a rule change
+    auto rule = database->Rules[0];
+    rule->SetCategory("Renamed Category");
+    database->MatchRule(rule->Id);
+    if (compare("Data", database->Data, "renamed categ") == 0)
+    {
+        Utils::PrintError("Search did not find the renamed category!");
+        success = false;
+    }
+    return success;
+}
+
+bool SummaryTest()
+{
+    bool success = true;
+    Settings config;
+    std::string configPath = "../test_data/settings.ini";
+    config.SetRuleSetFile("rules.csv");
+    config.SetInputDirectory("input1");
+    config.Save(configPath);
+    const char* testArgv[] = {"hokee", configPath.c_str(), nullptr};
+    int testArgc = sizeof(testArgv) / sizeof(testArgv[0]) - 1;
+    auto app = std::make_unique<Application>(testArgc, testArgv);
+    std::unique_ptr<CsvDatabase> database = app->RunBatch();
+
+    // Incrementally updated sums must match sums built from scratch
+    std::vector<CsvSymbol> categories = database->GetCategories();
+    categories.insert(categories.begin(), CsvSymbol());
+    auto compare = [&](const std::string& step) {
+        const CsvSummary& summary = database->GetSummary();
+        CsvSummary expected;
+        expected.Build(database->Data.GetColumns());
+        for (const auto& category : categories)
+        {
+            for (int year = summary.GetMinYear(); year <= summary.GetMaxYear(); ++year)
+            {
+                for (int month = 0; month <= 12; ++month)
+                {
+                    const CsvSummary::Cell& cell = summary.GetCell(category, year, month);
+                    const CsvSummary::Cell& expectedCell = expected.GetCell(category, year, month);
+                    if (cell.Sum != expectedCell.Sum || cell.Income != expectedCell.Income
+                        || cell.Expense != expectedCell.Expense || cell.Count != expectedCell.Count
+                        || cell.Sum != cell.Income + cell.Expense)
+                    {
+                        Utils::PrintError(fmt::format("Summary '{}' of {}-{} does not match after '{}'!",
+                                                      category.ToString(), month, year, step));
+                        success = false;
+                    }
+                }
+            }
+        }
+    };
+    compare("load");
+
+    // Items pages show the items of the summary cells
+    for (const auto& category : categories)
+    {
+        for (int year = database->GetSummary().GetMinYear(); year <= database->GetSummary().GetMaxYear(); ++year)
+        {
+            for (int month = 0; month <= 12 && !category.IsEmpty(); ++month)
+            {
+                int64_t itemsSum = 0;
+                for (const auto& item : database->GetItems(year, month, category.ToString(), -1))
+                {
+                    itemsSum += item->GetValue().GetCents();
+                }
+                if (itemsSum != database->GetSummary().GetCell(category, year, month).Expense)
+                {
+                    Utils::PrintError(fmt::format("Items of '{}' {}-{} do not match the summary!",
+                                                  category.ToString(), month, year));
+                    success = false;
+                }
+            }
+        }
+    }
+
+    // Sum of all years matches the items
+    int64_t sum = 0;
+    int64_t itemSum = 0;
+    for (int year = database->GetSummary().GetMinYear(); year <= database->GetSummary().GetMaxYear(); ++year)
+    {
+        for (const auto& category : categories)
+        {
+            if (!category.IsEmpty())
+            {
+                sum += database->GetSummary().GetCell(category, year, 0).Sum;
+            }
+        }
+    }
+    for (const auto& row : database->Data)
+    {
+        itemSum += row->GetCategory().IsEmpty() ? 0 : row->GetValue().GetCents();
+    }
+    if (sum != itemSum)
+    {
+        Utils::PrintError(fmt::format("Summary sum {} does not match the items {}!", sum, itemSum));
+        success = false;
+    }
+
+    // Rule changes
+    auto rule = database->Rules[0];
+    rule->SetCategory("New Category");
+    database->MatchRule(rule->Id);
+    categories.push_back(rule->GetCategory());
+    compare("edit");
+
+    // Edit only the category of a rule
+    rule->SetCategory(CsvSymbol("Other"));
+    database->MatchRule(rule->Id);
+    compare("category");
+
+    const int newId = database->NewRule(database->Unassigned[0]->Id);
+    database->MatchRule(newId);
+    compare("new");
+
+    database->DeleteRule(database->Rules[1]->Id);
+    compare("delete");
+    database->MatchRules();
+    compare("match");
+    return success;
+}
+
+bool PatternTest()
+{
+    bool success = true;
+    const std::vector<std::string> texts{"",       "abc",     "xabcx", "a.c",         "abc.def", "a1c",
+                                         "123",    "abc def", "$100",  "^start",      "end$",    "a\\b",
+                                         "a+b",    "(x)",     "x|y",   "supermarket", "super",   "market"};
+    const std::vector<std::pair<std::string, CsvPattern::Kind>> patterns{
+        {"", CsvPattern::Kind::Literal},          {"abc", CsvPattern::Kind::Literal},
+        {"^abc", CsvPattern::Kind::Prefix},       {"abc$", CsvPattern::Kind::Suffix},
+        {"^abc$", CsvPattern::Kind::Exact},       {"^", CsvPattern::Kind::Prefix},
+        {"$", CsvPattern::Kind::Suffix},          {"^$", CsvPattern::Kind::Exact},
+        {"a\\.c", CsvPattern::Kind::Literal},     {"^a\\.c$", CsvPattern::Kind::Exact},
+        {"\\$100", CsvPattern::Kind::Literal},    {"end\\$", CsvPattern::Kind::Literal},
+        {"\\^start", CsvPattern::Kind::Literal},  {"a\\+b", CsvPattern::Kind::Literal},
+        {"\\(x\\)", CsvPattern::Kind::Literal},   {"x\\|y", CsvPattern::Kind::Literal},
+        {"a\\\\b", CsvPattern::Kind::Literal},    {"a\\\\$", CsvPattern::Kind::Regex},
+        {"a.c", CsvPattern::Kind::Regex},         {"a\\dc", CsvPattern::Kind::Regex},
+        {"\\d+", CsvPattern::Kind::Regex},        {"\\bdef", CsvPattern::Kind::Regex},
+        {"abc\\b", CsvPattern::Kind::Regex},      {"^super|market$", CsvPattern::Kind::Regex},
+        {"^(abc)$", CsvPattern::Kind::Regex},     {"[ab]+c", CsvPattern::Kind::Regex},
+        {"su.*et", CsvPattern::Kind::Regex},      {"^\\d{3}$", CsvPattern::Kind::Regex}};
+
+    for (const auto& [pattern, kind] : patterns)
+    {
+        const CsvPattern csvPattern(pattern);
+        if (csvPattern.GetKind() != kind)
+        {
+            Utils::PrintError(fmt::format("Pattern '{}' has kind {} instead of {}!", pattern,
+                                          static_cast<int>(csvPattern.GetKind()), static_cast<int>(kind)));
+            success = false;
+        }
+        const std::regex regex(pattern);
+        for (const auto& text : texts)
+        {
+            if (csvPattern.Search(text) != std::regex_search(text, regex))
+            {
+                Utils::PrintError(fmt::format("Pattern '{}' does not match '{}' like std::regex_search!", pattern,
+                                              text));
+                success = false;
+            }
+        }
+    }
+
+    // Invalid patterns fail like std::regex
+    for (const char* pattern : {"(abc", "abc)", "[abc", "*abc", "a{2", "abc\\"})
+    {
+        bool regexThrows = false;
+        try
+        {
+            std::regex regex(pattern);
+        }
+        catch (const std::regex_error&)
+        {
+            regexThrows = true;
+        }
+        bool patternThrows = false;
+        try
+        {
+            CsvPattern csvPattern(pattern);
+        }
+        catch (const std::regex_error&)
+        {
+            patternThrows = true;
+        }
+        if (!regexThrows || !patternThrows)
+        {
+            Utils::PrintError(fmt::format("Invalid pattern '{}' did not throw (std::regex: {}, CsvPattern: {})!",
+                                          pattern, regexThrows, patternThrows));
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool RequiredLiteralTest()
+{
+    bool success = true;
+    // Quantifiers, groups, alternations and classes end a literal run or make the previous character optional
+    const std::vector<std::pair<std::string, std::string>> expectedLiterals{
+        {"abc", "abc"}, {"a\\.bc", "a.bc"}, {"super.*market", "market"}, {"abcd?e", "abc"}, {"ab+c", "ab"},
+        {"ab*cdef", "cdef"}, {"ab+?cd", "ab"}, {"x{2}yz", "yz"}, {"ab{1,3}", "a"}, {"(abc)def", "def"},
+        {"(a(b)c)de", "de"}, {"(a|b)cd", "cd"}, {"abc|def", ""}, {"[abc]defg", "defg"}, {"[a\\]b]cd", "cd"},
+        {"a\\wb", "a"}, {"foo\\bbar", "foo"}, {"^shop \\d+$", "shop "}, {"\\x41bc", ""},
+        {"\\d+ receipt", " receipt"}};
+    for (const auto& [pattern, expected] : expectedLiterals)
+    {
+        const CsvPattern csvPattern(pattern);
+        if (csvPattern.GetRequiredLiteral() != expected)
+        {
+            Utils::PrintError(fmt::format("Required literal of '{}' is '{}' instead of '{}'!", pattern,
+                                          csvPattern.GetRequiredLiteral(), expected));
+            success = false;
+        }
+    }
+
+    // Every text matched by std::regex_search contains the required literal
+    const std::vector<std::string> texts{"supermarket", "super market", "abce", "abcde", "abbbc", "acdef",
+                                         "xxyz",        "abd",          "abcdef", "bcd", "(abc)def", "abdefg",
+                                         "1 receipt",   "foo bar",      "shop 12", "a_b", "ab"};
+    for (const auto& [pattern, expected] : expectedLiterals)
+    {
+        const std::regex regex(pattern);
+        for (const auto& text : texts)
+        {
+            if (std::regex_search(text, regex) && text.find(expected) == std::string::npos)
+            {
+                Utils::PrintError(fmt::format("'{}' matches '{}' without its required literal '{}'!", text,
+                                              pattern, expected));
+                success = false;
+            }
+        }
+    }
+    return success;
+}
+
+bool AhoCorasickTest()
+{
+    bool success = true;
+    const std::vector<std::string> patterns{"he", "she", "his", "hers", "", "e", "ushers", "she"};
+    AhoCorasick automaton;
+    for (size_t p = 0; p < patterns.size(); ++p)
+    {
+        automaton.Add(patterns[p], static_cast<uint32_t>(p));
+    }
+    automaton.Build();
+
+    // Every occurrence is reported, the empty pattern never
+    for (const std::string text : {"ushers", "hishers", "sheshe", "", "xyz", "eeee", "HE"})
+    {
+        std::map<uint32_t, size_t> counts;
+        automaton.Search(text, [&counts](uint32_t id) { ++counts[id]; });
+
+        std::map<uint32_t, size_t> expected;
+        for (size_t p = 0; p < patterns.size(); ++p)
+        {
+            for (size_t pos = text.find(patterns[p]); !patterns[p].empty() && pos != std::string::npos;
+                 pos = text.find(patterns[p], pos + 1))
+            {
+                ++expected[static_cast<uint32_t>(p)];
+            }
+        }
+        if (counts != expected)
+        {
+            Utils::PrintError(fmt::format("Aho-Corasick found {} instead of {} in '{}'!", counts, expected, text));
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool RuleFilterTest()
+{
+    bool success = true;
+    const std::vector<std::string> payerPayees{"", "supermarket", "^super", "market$", "super.*et", "s(u|o)per",
+                                               "[sm]arket", "ab+c", "x?yz", "\\d+ shop", "^$"};
+    const std::vector<std::string> descriptions{"", "receipt", "receipt \\d{3}", "(receipt|invoice) 1",
+                                                "card\\b", "\\.de$", "a.c"};
+    CsvTable ruleItems;
+    for (size_t i = 0; i < payerPayees.size() * descriptions.size(); ++i)
+    {
+        const CsvRowShared& rule = ruleItems.AddItem();
+        rule->SetPayerPayee(payerPayees[i % payerPayees.size()]);
+        rule->SetDescription(descriptions[i / payerPayees.size()]);
+        rule->SetType(i % 5 == 0 ? "debit" : "");
+        rule->SetAccount(i % 7 == 0 ? "de\\d+" : "");
+    }
+    CsvPatternCache cache;
+    std::vector<CsvRule> rules;
+    for (auto& ruleItem : ruleItems)
+    {
+        rules.emplace_back(*ruleItem, cache);
+    }
+    CsvRuleFilter filter;
+    filter.Build(rules);
+
+    // The candidates of every item include all rules, whose patterns std::regex_search matches
+    std::vector<size_t> candidates;
+    for (const std::string payerPayee :
+         {"", "supermarket", "super", "my market", "soper", "abbbc", "xyz", "12 shop"})
+    {
+        for (const std::string description :
+             {"", "receipt 123", "invoice 1", "card payment", "cards", "shop.de", "abc", "x.y"})
+        {
+            CsvItem item;
+            item.SetPayerPayee(payerPayee);
+            item.SetDescription(description);
+            item.SetType("direct debit");
+            item.SetAccount("de1234");
+            filter.GetCandidates(item.GetColumns(), item.GetRow(), candidates);
+
+            for (size_t r = 0; r < rules.size(); ++r)
+            {
+                const CsvItem& rule = *ruleItems[r];
+                auto search = [](const std::string& pattern, const std::string& text) {
+                    return pattern.empty() || std::regex_search(text, std::regex(pattern));
+                };
+                const bool match = search(std::string(rule.GetPayerPayee()), std::string(item.GetPayerPayee()))
+                                   && search(std::string(rule.GetDescription()), std::string(item.GetDescription()))
+                                   && search(rule.GetType().ToString(), item.GetType().ToString())
+                                   && search(rule.GetAccount().ToString(), item.GetAccount().ToString());
+                if (match && !std::binary_search(candidates.begin(), candidates.end(), r))
+                {
+                    Utils::PrintError(fmt::format("Rule '{}' '{}' matches '{}' '{}', but is no candidate!",
+                                                  rule.GetPayerPayee(), rule.GetDescription(), payerPayee,
+                                                  description));
+                    success = false;
+                }
+            }
+        }
+    }
+    return success;
+}
+
 int main()
 {
     int result = 0;
@@ -247,6 +1601,28 @@ int main()
         result += runTest("RuleTest", RuleTest) ? 100 : 101;
         result += runTest("FormatTest", FormatTest) ? 100 : 101;
         result += runTest("HtmlTest", HtmlTest) ? 100 : 101;
+        result += runTest("HtmlWriterTest", HtmlWriterTest) ? 100 : 101;
+        result += runTest("ScannerTest", ScannerTest) ? 100 : 101;
+        result += runTest("ChunkedParserTest", ChunkedParserTest) ? 100 : 101;
+        result += runTest("IncrementalRuleTest", IncrementalRuleTest) ? 100 : 101;
+        result += runTest("ThreadPoolTest", ThreadPoolTest) ? 100 : 101;
+        result += runTest("MatchStressTest", MatchStressTest) ? 100 : 101;
+        result += runTest("SymbolTest", SymbolTest) ? 100 : 101;
+        result += runTest("ArenaTest", ArenaTest) ? 100 : 101;
+        result += runTest("ValueTest", ValueTest) ? 100 : 101;
+        result += runTest("DateTest", DateTest) ? 100 : 101;
+        result += runTest("SortTest", SortTest) ? 100 : 101;
+        result += runTest("MergeRunsTest", MergeRunsTest) ? 100 : 101;
+        result += runTest("TableIndexTest", TableIndexTest) ? 100 : 101;
+        result += runTest("TableViewTest", TableViewTest) ? 100 : 101;
+        result += runTest("TablePageChunkTest", TablePageChunkTest) ? 100 : 101;
+        result += runTest("TablePageWindowTest", TablePageWindowTest) ? 100 : 101;
+        result += runTest("TextIndexTest", TextIndexTest) ? 100 : 101;
+        result += runTest("SummaryTest", SummaryTest) ? 100 : 101;
+        result += runTest("PatternTest", PatternTest) ? 100 : 101;
+        result += runTest("RequiredLiteralTest", RequiredLiteralTest) ? 100 : 101;
+        result += runTest("AhoCorasickTest", AhoCorasickTest) ? 100 : 101;
+        result += runTest("RuleFilterTest", RuleFilterTest) ? 100 : 101;
     }
     catch (const UserException& e)
     {